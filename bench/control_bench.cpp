@@ -0,0 +1,661 @@
+// Micro-benchmarks for the control algorithms, no ROS required.
+//
+//   control_bench [--filter <substring>] [--min_time <seconds>] [--json <file>]
+//
+// Reports ns/op and heap allocations per op. The JSON output follows the Google Benchmark
+// layout (context + benchmarks[]) so results can be compared with the usual tooling.
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "control_core.h"
+#include "path_spline.h"
+#include "path_tracking.h"
+#include "scan_collision.h"
+#include "rolling_bit_grid.h"
+#include "distance_field.h"
+#include "path_controllers.h"
+#include "mpc_controller.h"
+
+// Count Every Heap Allocation in the Process
+static std::atomic<uint64_t> AllocCount(0);
+
+void* operator new(std::size_t size)
+{
+    AllocCount.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = malloc(size ? size : 1);
+    if(!ptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    free(ptr);
+}
+
+// Keeps the Compiler from Dropping Unused Results
+template <class T>
+static inline void DoNotOptimize(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Timing State Handed to Each Benchmark, Setup Between Pause() and Resume() Is Not Counted
+class BenchState
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    explicit BenchState(uint64_t iterations): Iterations(iterations), Elapsed(0), Allocs(0), Running(false) {}
+
+    uint64_t Size() const { return Iterations; }
+
+    void Resume()
+    {
+        Running = true;
+        AllocStart = AllocCount.load(std::memory_order_relaxed);
+        Start = Clock::now();
+    }
+
+    void Pause()
+    {
+        Clock::time_point stop = Clock::now();
+        Allocs += AllocCount.load(std::memory_order_relaxed) - AllocStart;
+        Elapsed += std::chrono::duration<double, std::nano>(stop - Start).count();
+        Running = false;
+    }
+
+    double   ElapsedNs() const { return Elapsed; }
+    uint64_t AllocsTotal() const { return Allocs; }
+
+private:
+    uint64_t            Iterations;
+    double              Elapsed;
+    uint64_t            Allocs;
+    uint64_t            AllocStart;
+    Clock::time_point   Start;
+    bool                Running;
+};
+
+struct Bench_t{
+    std::string                         name;
+    std::function<void(BenchState&)>    run;
+};
+
+struct Result_t{
+    std::string name;
+    uint64_t    iterations;
+    double      ns_per_op;
+    double      allocs_per_op;
+};
+
+// Realistic Input: Waypoints Every 5 cm Along a Gently Winding Corridor
+static void MakeWaypoints(int count, std::vector<float> &x, std::vector<float> &y, std::vector<float> &theta)
+{
+    x.resize(count);
+    y.resize(count);
+    theta.resize(count);
+    for(int i = 0; i < count; i++)
+    {
+        float s = 0.05 * i;
+        x[i] = s;
+        y[i] = 1.5 * sin(0.2 * s);
+        theta[i] = atan2(0.3 * cos(0.2 * s), 1.0);
+    }
+}
+
+static void LoadPath(TrackingPath_t &path, const std::vector<float> &x, const std::vector<float> &y, const std::vector<float> &theta, bool spline)
+{
+    ClearTrackingPath(path);
+    for(size_t i = 0; i < x.size(); i++)
+    {
+        path.x.push(x[i]);
+        path.y.push(y[i]);
+        path.theta.push(theta[i]);
+    }
+    if(spline)
+    {
+        path.curve.Fit(x, y, theta);
+    }
+}
+
+// One op is one PurePursuit call while the robot drives the path, reloading it when finished
+static void BenchPurePursuit(BenchState &state, int count, bool spline)
+{
+    std::vector<float> x, y, theta;
+    MakeWaypoints(count, x, y, theta);
+
+    TrackingPath_t path;
+    LoadPath(path, x, y, theta, spline);
+    TrackingPose_t robot = {x[0], y[0], theta[0]};
+
+    state.Resume();
+    for(uint64_t i = 0; i < state.Size(); i++)
+    {
+        bool finished = false;
+        TrackingPose_t target = spline ? PurePursuitSpline(robot, path, 0.1, false, finished)
+                                       : PurePursuit(robot, path, 0.1, false, finished);
+        DoNotOptimize(target);
+
+        // Robot Covers Most of the Gap Each Tick
+        robot.x += 0.6 * (target.x - robot.x);
+        robot.y += 0.6 * (target.y - robot.y);
+        robot.theta = target.theta;
+
+        if(finished || (!spline && path.x.empty()))
+        {
+            state.Pause();
+            LoadPath(path, x, y, theta, spline);
+            robot.x = x[0];
+            robot.y = y[0];
+            robot.theta = theta[0];
+            state.Resume();
+        }
+    }
+    state.Pause();
+}
+
+static void BenchSplineFit(BenchState &state, int count)
+{
+    std::vector<float> x, y, theta;
+    MakeWaypoints(count, x, y, theta);
+    PathSpline curve;
+
+    state.Resume();
+    for(uint64_t i = 0; i < state.Size(); i++)
+    {
+        curve.Fit(x, y, theta);
+        DoNotOptimize(curve.Length());
+    }
+    state.Pause();
+}
+
+static void BenchSplineSample(BenchState &state, int count)
+{
+    std::vector<float> x, y, theta;
+    MakeWaypoints(count, x, y, theta);
+    PathSpline curve;
+    curve.Fit(x, y, theta);
+
+    float length = curve.Length();
+    float s = 0.0;
+
+    state.Resume();
+    for(uint64_t i = 0; i < state.Size(); i++)
+    {
+        PathSpline::Sample_t sample = curve.Sample(s);
+        DoNotOptimize(sample);
+        s += 0.37;
+        if(s > length)
+        {
+            s -= length;
+        }
+    }
+    state.Pause();
+}
+
+static void BenchSplineProject(BenchState &state, int count)
+{
+    std::vector<float> x, y, theta;
+    MakeWaypoints(count, x, y, theta);
+    PathSpline curve;
+    curve.Fit(x, y, theta);
+
+    float length = curve.Length();
+    float s = 0.0;
+
+    state.Resume();
+    for(uint64_t i = 0; i < state.Size(); i++)
+    {
+        PathSpline::Sample_t sample = curve.Sample(s);
+        float progress = curve.Project(sample.x + 0.02, sample.y - 0.02, s > 0.2 ? s - 0.2 : 0.0, s + 1.0);
+        DoNotOptimize(progress);
+        s += 0.05;
+        if(s > length)
+        {
+            s = 0.0;
+        }
+    }
+    state.Pause();
+}
+
+// One op is one controller Compute() on a target 10 cm ahead of a slightly offset robot
+static void BenchController(BenchState &state, const char* name)
+{
+    PathController_t controller;
+    MakePathController(name, DefaultPathControllerConfig(), controller);
+
+    std::vector<float> x, y, theta;
+    MakeWaypoints(1000, x, y, theta);
+
+    TrackingInput_t input;
+    input.dt = 0.005;
+    input.max_speed = 0.0;
+
+    state.Resume();
+    for(uint64_t i = 0; i < state.Size(); i++)
+    {
+        size_t k = i % (x.size() - MpcController::HORIZON - 2);
+        input.robot.x = x[k] + 0.01;
+        input.robot.y = y[k] - 0.01;
+        input.robot.theta = theta[k] + 0.02;
+        input.target.x = x[k+2];
+        input.target.y = y[k+2];
+        input.target.theta = theta[k+2];
+        for(int h = 0; h < MpcController::HORIZON; h++)
+        {
+            input.horizon[h].x = x[k+h+1];
+            input.horizon[h].y = y[k+h+1];
+            input.horizon[h].theta = theta[k+h+1];
+        }
+
+        TrackingPose_t command = ComputePathController(controller, input);
+        DoNotOptimize(command);
+    }
+    state.Pause();
+}
+
+// One op is one guided-mode ControlCore::Step() while the robot drives the path
+static void BenchControlCore(BenchState &state, int count, const char* controller)
+{
+    std::vector<float> x, y, theta;
+    MakeWaypoints(count, x, y, theta);
+
+    ControlCore core;
+    core.RequestController(controller);
+
+    TrackingPath_t path;
+    LoadPath(path, x, y, theta, true);
+
+    // Enter Guided Mode and Start, Untimed
+    ControlCore::Input_t input = ControlCore::Input_t();
+    input.pose.x = x[0];
+    input.pose.y = y[0];
+    input.pose.theta = theta[0];
+    input.buttons[ControlCore::OPTIONS] = 1;
+    input.buttons[ControlCore::TRIANGLE] = 1;
+    core.Step(input, 0.005);
+    input.buttons[ControlCore::OPTIONS] = 0;
+    input.buttons[ControlCore::TRIANGLE] = 0;
+    input.path = &path;
+
+    state.Resume();
+    for(uint64_t i = 0; i < state.Size(); i++)
+    {
+        const ControlCore::Output_t &out = core.Step(input, 0.005);
+        DoNotOptimize(out.command);
+        input.path = NULL;
+
+        input.pose.x += 0.6 * (out.target.x - input.pose.x);
+        input.pose.y += 0.6 * (out.target.y - input.pose.y);
+        input.pose.theta = out.target.theta;
+
+        if(!core.Tracking())
+        {
+            state.Pause();
+            LoadPath(path, x, y, theta, true);
+            input.path = &path;
+            input.pose.x = x[0];
+            input.pose.y = y[0];
+            input.pose.theta = theta[0];
+            state.Resume();
+        }
+    }
+    state.Pause();
+}
+
+// Corridor Scan: Walls 0.6 m Either Side, a Box 1.2 m Ahead, Some Dropped Returns
+static void MakeScan(int count, float &angle_min, float &increment, std::vector<float> &ranges)
+{
+    angle_min = -M_PI;
+    increment = 2.0 * M_PI / count;
+    ranges.resize(count);
+    for(int i = 0; i < count; i++)
+    {
+        float angle = angle_min + i * increment;
+        float wall = 0.6 / std::max(fabs(sin(angle)), 1e-3);
+        float ahead = (cos(angle) > 0.9) ? 1.2 / cos(angle) : 1e9;
+        ranges[i] = (i % 37 == 0) ? INFINITY : std::min(std::min(wall, ahead), 12.0f);
+    }
+}
+
+// One op is one time-to-collision check of a new velocity over the whole scan
+static void BenchScanCheck(BenchState &state, int count)
+{
+    float angle_min, increment;
+    std::vector<float> ranges;
+    MakeScan(count, angle_min, increment, ranges);
+
+    ScanCollisionChecker checker;
+    checker.Update(angle_min, increment, ranges.data(), count, 0.15, 12.0);
+
+    state.Resume();
+    for(uint64_t i = 0; i < state.Size(); i++)
+    {
+        float heading = 0.001 * (i % 6283);
+        float ttc = checker.TimeToCollision(0.3 * cos(heading), 0.3 * sin(heading));
+        DoNotOptimize(ttc);
+    }
+    state.Pause();
+}
+
+// One op is converting one scan to base_link points
+static void BenchScanUpdate(BenchState &state, int count)
+{
+    float angle_min, increment;
+    std::vector<float> ranges;
+    MakeScan(count, angle_min, increment, ranges);
+
+    ScanCollisionChecker checker;
+
+    state.Resume();
+    for(uint64_t i = 0; i < state.Size(); i++)
+    {
+        checker.Update(angle_min, increment, ranges.data(), count, 0.15, 12.0);
+        DoNotOptimize(checker);
+    }
+    state.Pause();
+}
+
+// One op is scrolling the grid with a drifting robot and ray-marking one scan into it
+static void BenchGridInsert(BenchState &state, int count)
+{
+    float angle_min, increment;
+    std::vector<float> ranges;
+    MakeScan(count, angle_min, increment, ranges);
+
+    RollingBitGrid grid;
+    RollingBitGrid::Pose_t laser = {0.0, 0.0, 0.0};
+
+    state.Resume();
+    for(uint64_t i = 0; i < state.Size(); i++)
+    {
+        laser.x = 0.01 * (i % 400);
+        laser.theta = 0.001 * (i % 6283);
+        grid.Scroll(laser.x, laser.y);
+        grid.InsertScan(laser, angle_min, increment, ranges.data(), count, 0.15, 12.0);
+        DoNotOptimize(grid);
+    }
+    state.Pause();
+}
+
+// One op is one footprint query at a point near the robot
+static void BenchGridFootprint(BenchState &state)
+{
+    float angle_min, increment;
+    std::vector<float> ranges;
+    MakeScan(720, angle_min, increment, ranges);
+
+    RollingBitGrid grid;
+    RollingBitGrid::Pose_t laser = {0.0, 0.0, 0.0};
+    grid.Scroll(0.0, 0.0);
+    grid.InsertScan(laser, angle_min, increment, ranges.data(), 720, 0.15, 12.0);
+
+    state.Resume();
+    for(uint64_t i = 0; i < state.Size(); i++)
+    {
+        float heading = 0.001 * (i % 6283);
+        bool free = grid.FootprintFree(0.2 * cos(heading), 0.2 * sin(heading));
+        DoNotOptimize(free);
+    }
+    state.Pause();
+}
+
+// One op is the distance transform of a size x size map with walls and scattered obstacles
+static void BenchDistanceField(BenchState &state, int size, int threads)
+{
+    std::vector<uint8_t> obstacle((size_t)size * size, 0);
+    uint32_t seed = 12345;
+    for(int y = 0; y < size; y++)
+    {
+        for(int x = 0; x < size; x++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            bool wall = x == 0 || y == 0 || x == size - 1 || y == size - 1 || (x % 80 == 40 && y % 100 < 70);
+            obstacle[(size_t)y * size + x] = wall || (seed >> 24) < 2;
+        }
+    }
+
+    DistanceField field;
+    state.Resume();
+    for(uint64_t i = 0; i < state.Size(); i++)
+    {
+        field.Compute(obstacle.data(), size, size, 0.05, 0.0, 0.0, threads);
+        DoNotOptimize(field);
+    }
+    state.Pause();
+}
+
+static void BenchGlobalToLocalVel(BenchState &state)
+{
+    TrackingPose_t robot = {1.0, 2.0, 0.0};
+    TrackingPose_t vel = {12.0, -7.0, 3.0};
+
+    state.Resume();
+    for(uint64_t i = 0; i < state.Size(); i++)
+    {
+        robot.theta += 0.001;
+        TrackingPose_t local = GlobalToLocalVel(robot, vel);
+        DoNotOptimize(local);
+    }
+    state.Pause();
+}
+
+static std::vector<Bench_t> Registry()
+{
+    std::vector<Bench_t> benches;
+    const int sizes[] = {100, 10000, 100000};
+
+    for(int n : sizes)
+    {
+        benches.push_back({"PurePursuit/" + std::to_string(n), [n](BenchState &s) { BenchPurePursuit(s, n, false); }});
+    }
+    for(int n : sizes)
+    {
+        benches.push_back({"PurePursuitSpline/" + std::to_string(n), [n](BenchState &s) { BenchPurePursuit(s, n, true); }});
+    }
+    for(int n : sizes)
+    {
+        benches.push_back({"PathSpline_Fit/" + std::to_string(n), [n](BenchState &s) { BenchSplineFit(s, n); }});
+    }
+    for(int n : sizes)
+    {
+        benches.push_back({"PathSpline_Sample/" + std::to_string(n), [n](BenchState &s) { BenchSplineSample(s, n); }});
+    }
+    for(int n : sizes)
+    {
+        benches.push_back({"PathSpline_Project/" + std::to_string(n), [n](BenchState &s) { BenchSplineProject(s, n); }});
+    }
+
+    const char* controllers[] = {"lqr", "pid", "pid_v2", "mpc"};
+    for(const char* name : controllers)
+    {
+        benches.push_back({std::string("Controller/") + name, [name](BenchState &s) { BenchController(s, name); }});
+    }
+
+    for(const char* name : controllers)
+    {
+        benches.push_back({std::string("ControlCore_Step/") + name, [name](BenchState &s) { BenchControlCore(s, 10000, name); }});
+    }
+
+    const int beams[] = {360, 720, 2048};
+    for(int n : beams)
+    {
+        benches.push_back({"ScanCheck_TTC/" + std::to_string(n), [n](BenchState &s) { BenchScanCheck(s, n); }});
+    }
+    for(int n : beams)
+    {
+        benches.push_back({"ScanCheck_Update/" + std::to_string(n), [n](BenchState &s) { BenchScanUpdate(s, n); }});
+    }
+    for(int n : beams)
+    {
+        benches.push_back({"BitGrid_Insert/" + std::to_string(n), [n](BenchState &s) { BenchGridInsert(s, n); }});
+    }
+    benches.push_back({"BitGrid_Footprint", BenchGridFootprint});
+
+    const int map_sizes[] = {400, 1000, 2000};
+    for(int n : map_sizes)
+    {
+        benches.push_back({"DistanceField/" + std::to_string(n), [n](BenchState &s) { BenchDistanceField(s, n, 0); }});
+    }
+    benches.push_back({"DistanceField_1Thread/1000", [](BenchState &s) { BenchDistanceField(s, 1000, 1); }});
+    benches.push_back({"GlobalToLocalVel", BenchGlobalToLocalVel});
+    return benches;
+}
+
+// Grow the Iteration Count Until a Run Takes at Least min_time
+static Result_t RunBench(const Bench_t &bench, double min_time)
+{
+    uint64_t iterations = 1;
+    while(true)
+    {
+        BenchState state(iterations);
+        bench.run(state);
+
+        double elapsed = state.ElapsedNs();
+        if(elapsed >= min_time * 1e9 || iterations >= (1ull << 32))
+        {
+            Result_t result;
+            result.name = bench.name;
+            result.iterations = iterations;
+            result.ns_per_op = elapsed / iterations;
+            result.allocs_per_op = (double)state.AllocsTotal() / iterations;
+            return result;
+        }
+
+        // Aim for min_time Directly, at Most 10x Growth per Round
+        double scale = (elapsed > 0.0) ? 1.4 * min_time * 1e9 / elapsed : 10.0;
+        if(scale > 10.0)
+        {
+            scale = 10.0;
+        }
+        if(scale < 2.0)
+        {
+            scale = 2.0;
+        }
+        iterations = (uint64_t)(iterations * scale);
+    }
+}
+
+static bool WriteJson(const char* filename, const std::vector<Result_t> &results)
+{
+    FILE* file = fopen(filename, "w");
+    if(!file)
+    {
+        return false;
+    }
+
+    char host[256] = "unknown";
+    gethostname(host, sizeof(host) - 1);
+
+    char date[64];
+    time_t now = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+
+    fprintf(file, "{\n  \"context\": {\n");
+    fprintf(file, "    \"date\": \"%s\",\n", date);
+    fprintf(file, "    \"host_name\": \"%s\",\n", host);
+    fprintf(file, "    \"executable\": \"control_bench\",\n");
+    fprintf(file, "    \"num_cpus\": %ld\n", sysconf(_SC_NPROCESSORS_ONLN));
+    fprintf(file, "  },\n  \"benchmarks\": [\n");
+    for(size_t i = 0; i < results.size(); i++)
+    {
+        const Result_t &r = results[i];
+        fprintf(file, "    {\n");
+        fprintf(file, "      \"name\": \"%s\",\n", r.name.c_str());
+        fprintf(file, "      \"run_type\": \"iteration\",\n");
+        fprintf(file, "      \"iterations\": %llu,\n", (unsigned long long)r.iterations);
+        fprintf(file, "      \"real_time\": %.3f,\n", r.ns_per_op);
+        fprintf(file, "      \"time_unit\": \"ns\",\n");
+        fprintf(file, "      \"allocs_per_op\": %.4f\n", r.allocs_per_op);
+        fprintf(file, "    }%s\n", (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    const char* json = NULL;
+    double min_time = 0.2;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--filter") && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--min_time") && i + 1 < argc)
+        {
+            min_time = atof(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--json") && i + 1 < argc)
+        {
+            json = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--filter <substring>] [--min_time <seconds>] [--json <file>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<Result_t> results;
+
+    printf("%-28s %14s %14s %12s\n", "Benchmark", "Iterations", "ns/op", "allocs/op");
+    for(const Bench_t &bench : Registry())
+    {
+        if(!filter.empty() && bench.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        Result_t result = RunBench(bench, min_time);
+        printf("%-28s %14llu %14.1f %12.4f\n", result.name.c_str(), (unsigned long long)result.iterations, result.ns_per_op, result.allocs_per_op);
+        fflush(stdout);
+        results.push_back(result);
+    }
+
+    if(json && !WriteJson(json, results))
+    {
+        fprintf(stderr, "Failed to write %s\n", json);
+        return 1;
+    }
+    return 0;
+}
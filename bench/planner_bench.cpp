@@ -0,0 +1,375 @@
+// Planner benchmark over stored maps, no ROS required.
+//
+//   planner_bench [--queries N] [--inflation M] [--seed S] [--json <file>] map.yaml ...
+//
+// For each map the same random start and goal pairs, drawn from the free cells, are planned
+// with A* and with Jump Point Search on one GridPlanner each. Reports time per query (mean,
+// median, max), nodes expanded and heap insertions, and checks that both find paths of the
+// same length.
+//
+// Replanning is measured with D* Lite on the same pairs: once the path is known, a disk of the
+// inflation radius is blocked on it a metre ahead of the start, as the scan would see it, then the kept search is repaired ("repair") and,
+// for comparison, a new D* Lite search is run on the blocked grid ("dstar"). Both must agree.
+//
+// The JPS paths are also passed through PathShortcut, as Robot does with each incoming /path,
+// reporting the time per path and the drop in poses and length.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "distance_field.h"
+#include "dstar_lite.h"
+#include "grid_planner.h"
+#include "occupancy_map.h"
+#include "path_shortcut.h"
+
+struct Result_t{
+    std::string map;
+    std::string algorithm;
+    int     queries;
+    int     found;
+    double  mean_us;
+    double  median_us;
+    double  max_us;
+    double  expanded;
+    double  pushed;
+    double  length;
+};
+
+struct ShortcutResult_t{
+    std::string map;
+    int     paths;
+    double  mean_us;
+    double  max_us;
+    double  input_points;
+    double  output_points;
+    double  input_length;
+    double  output_length;
+};
+
+static float CellPathLength(const std::vector<int> &cells, int width, float resolution)
+{
+    float length = 0.0;
+    for(size_t i = 1; i < cells.size(); i++)
+    {
+        bool diagonal = cells[i] % width != cells[i - 1] % width && cells[i] / width != cells[i - 1] / width;
+        length += (diagonal ? 1.41421356f : 1.0f) * resolution;
+    }
+    return length;
+}
+
+static void Summarise(Result_t &r, std::vector<double> &times)
+{
+    if(times.empty())
+    {
+        return;
+    }
+    std::vector<double> sorted = times;
+    std::sort(sorted.begin(), sorted.end());
+    for(double t : times)
+    {
+        r.mean_us += t / times.size();
+    }
+    r.median_us = sorted[sorted.size() / 2];
+    r.max_us = sorted.back();
+    r.expanded /= times.size();
+    r.pushed /= times.size();
+    r.length = r.found ? r.length / r.found : 0.0;
+}
+
+static void PrintResult(const Result_t &r)
+{
+    printf("%-32s %-6s %3d/%-3d %10.1f %10.1f %10.1f %10.0f %10.0f %8.2fm\n", r.map.c_str(), r.algorithm.c_str(),
+           r.found, r.queries, r.mean_us, r.median_us, r.max_us, r.expanded, r.pushed, r.length);
+}
+
+static bool WriteJson(const char* filename, const std::vector<Result_t> &results,
+                      const std::vector<ShortcutResult_t> &shortcuts)
+{
+    FILE* file = fopen(filename, "w");
+    if(!file)
+    {
+        return false;
+    }
+    fprintf(file, "{\n  \"results\": [\n");
+    for(size_t i = 0; i < results.size(); i++)
+    {
+        const Result_t &r = results[i];
+        fprintf(file, "    {\"map\": \"%s\", \"algorithm\": \"%s\", \"queries\": %d, \"found\": %d, "
+                      "\"mean_us\": %.2f, \"median_us\": %.2f, \"max_us\": %.2f, \"expanded\": %.1f, "
+                      "\"pushed\": %.1f, \"length\": %.3f}%s\n",
+                r.map.c_str(), r.algorithm.c_str(), r.queries, r.found, r.mean_us, r.median_us, r.max_us,
+                r.expanded, r.pushed, r.length, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ],\n  \"shortcut\": [\n");
+    for(size_t i = 0; i < shortcuts.size(); i++)
+    {
+        const ShortcutResult_t &r = shortcuts[i];
+        fprintf(file, "    {\"map\": \"%s\", \"paths\": %d, \"mean_us\": %.2f, \"max_us\": %.2f, "
+                      "\"input_points\": %.1f, \"output_points\": %.1f, \"input_length\": %.3f, "
+                      "\"output_length\": %.3f}%s\n",
+                r.map.c_str(), r.paths, r.mean_us, r.max_us, r.input_points, r.output_points, r.input_length,
+                r.output_length, i + 1 < shortcuts.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return fclose(file) == 0;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> maps;
+    int queries = 200;
+    float inflation = 0.3;
+    unsigned seed = 1;
+    const char* json = NULL;
+
+    for(int i = 1; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(argv[i], "--queries") && has_value)          queries = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--inflation") && has_value)   inflation = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--seed") && has_value)        seed = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--json") && has_value)        json = argv[++i];
+        else if(argv[i][0] != '-')                              maps.push_back(argv[i]);
+        else
+        {
+            fprintf(stderr, "Usage: %s [--queries N] [--inflation M] [--seed S] [--json <file>] map.yaml ...\n", argv[0]);
+            return 1;
+        }
+    }
+    if(maps.empty() || queries <= 0)
+    {
+        fprintf(stderr, "Usage: %s [--queries N] [--inflation M] [--seed S] [--json <file>] map.yaml ...\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<Result_t> results;
+    std::vector<ShortcutResult_t> shortcuts;
+    int mismatches = 0;
+    printf("%-32s %-6s %7s %10s %10s %10s %10s %10s %9s\n", "Map", "Algo", "Found", "Mean(us)", "Median(us)",
+           "Max(us)", "Expanded", "Pushed", "Length");
+    for(const std::string &yaml_path : maps)
+    {
+        OccupancyMap map;
+        DistanceField field;
+        std::string error;
+        if(!map.Load(yaml_path, error))
+        {
+            fprintf(stderr, "%s: %s\n", yaml_path.c_str(), error.c_str());
+            return 1;
+        }
+        field.Compute(map, true, 0);
+
+        GridPlanner planners[2];
+        GridPlanner::Algorithm_t algorithms[2] = {GridPlanner::ASTAR, GridPlanner::JPS};
+        for(int a = 0; a < 2; a++)
+        {
+            GridPlanner::Config_t config = planners[a].Config();
+            config.algorithm = algorithms[a];
+            config.inflation_radius = inflation;
+            planners[a].Configure(config);
+            planners[a].SetMap(field);
+        }
+
+        // Query Pairs from the Free Cells, the Same for Both Algorithms
+        std::vector<int> free_cells;
+        for(int y = 0; y < planners[0].Height(); y++)
+        {
+            for(int x = 0; x < planners[0].Width(); x++)
+            {
+                if(planners[0].Free(x, y))
+                {
+                    free_cells.push_back(y * planners[0].Width() + x);
+                }
+            }
+        }
+        if(free_cells.size() < 2)
+        {
+            fprintf(stderr, "%s: no free cells at inflation %.2f m\n", yaml_path.c_str(), inflation);
+            return 1;
+        }
+        srand(seed);
+        std::vector<int> starts(queries), goals(queries);
+        for(int q = 0; q < queries; q++)
+        {
+            starts[q] = free_cells[rand() % free_cells.size()];
+            goals[q] = free_cells[rand() % free_cells.size()];
+        }
+
+        std::vector<std::vector<float> > lengths(2, std::vector<float>(queries, -1.0));
+        std::vector<int> cells;
+        for(int a = 0; a < 2; a++)
+        {
+            Result_t r = Result_t();
+            r.map = yaml_path;
+            r.algorithm = GridPlanner::AlgorithmName(algorithms[a]);
+            r.queries = queries;
+            std::vector<double> times(queries);
+            for(int q = 0; q < queries; q++)
+            {
+                auto start = std::chrono::steady_clock::now();
+                bool found = planners[a].PlanCells(starts[q], goals[q], cells);
+                times[q] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+                const GridPlanner::Stats_t &stats = planners[a].Stats();
+                r.expanded += stats.expanded;
+                r.pushed += stats.pushed;
+                if(found)
+                {
+                    float length = CellPathLength(cells, planners[a].Width(), planners[a].Resolution());
+                    lengths[a][q] = length;
+                    r.length += length;
+                    r.found++;
+                }
+            }
+
+            Summarise(r, times);
+            PrintResult(r);
+            results.push_back(r);
+        }
+
+        // D* Lite After a Blockage One Metre Ahead, on Paths Long Enough to Leave Start and Goal Free
+        Result_t fresh = Result_t(), repair = Result_t();
+        fresh.map = repair.map = yaml_path;
+        fresh.algorithm = "dstar";
+        repair.algorithm = "repair";
+        std::vector<double> fresh_times, repair_times;
+        DStarLite kept, scratch;
+        int width = planners[0].Width();
+        float resolution = planners[0].Resolution();
+        int margin = (int)ceil(2.0 * inflation / resolution) + 2;
+        int ahead = std::max(margin, (int)(1.0 / resolution));
+        for(int q = 0; q < queries; q++)
+        {
+            kept.SetMap(planners[0]);
+            if(!kept.Start(starts[q], goals[q]) || !kept.Replan(starts[q], cells) || (int)cells.size() < ahead + margin)
+            {
+                continue;
+            }
+            std::vector<GridPlanner::Point_t> blockage(1, planners[0].CellCenter(cells[ahead]));
+            fresh.queries++;
+            repair.queries++;
+
+            auto start = std::chrono::steady_clock::now();
+            kept.AddObstacles(blockage, inflation);
+            bool repaired = kept.Replan(starts[q], cells);
+            repair_times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+            float repair_length = repaired ? CellPathLength(cells, width, resolution) : -1.0f;
+            repair.expanded += kept.Stats().expanded;
+            repair.pushed += kept.Stats().pushed;
+
+            scratch.SetMap(planners[0]);
+            scratch.AddObstacles(blockage, inflation);
+            start = std::chrono::steady_clock::now();
+            bool found = scratch.Start(starts[q], goals[q]);
+            fresh.expanded += scratch.Stats().expanded;
+            found = found && scratch.Replan(starts[q], cells);
+            fresh_times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+            float fresh_length = found ? CellPathLength(cells, width, resolution) : -1.0f;
+            fresh.expanded += scratch.Stats().expanded;
+            fresh.pushed += scratch.Stats().pushed;
+
+            if(repaired)
+            {
+                repair.found++;
+                repair.length += repair_length;
+            }
+            if(found)
+            {
+                fresh.found++;
+                fresh.length += fresh_length;
+            }
+            if(fabs(repair_length - fresh_length) > 1e-3)
+            {
+                mismatches++;
+            }
+        }
+        Summarise(fresh, fresh_times);
+        Summarise(repair, repair_times);
+        PrintResult(fresh);
+        PrintResult(repair);
+        results.push_back(fresh);
+        results.push_back(repair);
+
+        // Shortcut and Smoothing of the JPS Paths
+        ShortcutResult_t shortcut = ShortcutResult_t();
+        shortcut.map = yaml_path;
+        PathShortcut::Config_t shortcut_config = PathShortcut().Config();
+        shortcut_config.inflation_radius = inflation;
+        PathShortcut smoother;
+        smoother.Configure(shortcut_config);
+        smoother.SetMap(field);
+        std::vector<PathShortcut::Point_t> raw, smooth;
+        for(int q = 0; q < queries; q++)
+        {
+            if(!planners[1].PlanCells(starts[q], goals[q], cells))
+            {
+                continue;
+            }
+            raw.resize(cells.size());
+            for(size_t i = 0; i < cells.size(); i++)
+            {
+                GridPlanner::Point_t point = planners[1].CellCenter(cells[i]);
+                raw[i].x = point.x;
+                raw[i].y = point.y;
+                raw[i].theta = 0.0;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            smoother.Process(raw, smooth);
+            double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+            const PathShortcut::Stats_t &stats = smoother.Stats();
+            shortcut.paths++;
+            shortcut.mean_us += elapsed;
+            shortcut.max_us = std::max(shortcut.max_us, elapsed);
+            shortcut.input_points += stats.input_points;
+            shortcut.output_points += stats.output_points;
+            shortcut.input_length += stats.input_length;
+            shortcut.output_length += stats.output_length;
+        }
+        if(shortcut.paths)
+        {
+            shortcut.mean_us /= shortcut.paths;
+            shortcut.input_points /= shortcut.paths;
+            shortcut.output_points /= shortcut.paths;
+            shortcut.input_length /= shortcut.paths;
+            shortcut.output_length /= shortcut.paths;
+        }
+        shortcuts.push_back(shortcut);
+
+        // Both Are Optimal on the Same Grid, Lengths Must Agree
+        for(int q = 0; q < queries; q++)
+        {
+            if(fabs(lengths[0][q] - lengths[1][q]) > 1e-3)
+            {
+                mismatches++;
+            }
+        }
+    }
+
+    printf("\n%-32s %7s %10s %10s %15s %19s\n", "Map", "Paths", "Mean(us)", "Max(us)", "Poses", "Length");
+    for(const ShortcutResult_t &r : shortcuts)
+    {
+        printf("%-32s %7d %10.1f %10.1f %6.0f -> %-5.0f %7.2fm -> %6.2fm\n", r.map.c_str(), r.paths, r.mean_us,
+               r.max_us, r.input_points, r.output_points, r.input_length, r.output_length);
+    }
+
+    if(json && !WriteJson(json, results, shortcuts))
+    {
+        fprintf(stderr, "Failed to write %s\n", json);
+        return 1;
+    }
+    if(mismatches)
+    {
+        fprintf(stderr, "%d queries with different path lengths between A* and JPS or D* Lite repair and search\n", mismatches);
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+#ifndef COMMAND_LINK_H
+#define COMMAND_LINK_H
+
+#include <stdint.h>
+#include <string>
+
+// Host side of the command link to the base firmware, without ROS.
+//
+// legacy: "mri", int16 data[3] in cm/s, BitLamp, StatusControl (11 bytes, no check).
+//
+// v1 frame, little endian:
+//   0xA5 0x5A | version (1) | type | payload length | payload | CRC16-CCITT
+//   The CRC (poly 0x1021, init 0xFFFF) covers version through payload.
+//   type 0x01 command, 17 bytes:
+//     uint16 seq | int16 velocity[3] in 0.1 cm/s (0.1 angular units) |
+//     int16 accel[3] in cm/s^2 (angular units/s) | uint8 BitLamp | uint8 StatusControl |
+//     uint8 flags (bit 0: accel valid)
+//   type 0x81 ack from the firmware, 4 bytes:
+//     uint16 seq of the accepted command | uint8 status (bit 0: bad frame seen) |
+//     uint8 commands the firmware saw skipped in seq since its last ack
+//
+// Acks share the serial stream with the odometry text; the sync bytes never occur in text,
+// so Extract() lifts them out and leaves the text in place.
+class CommandLink
+{
+public:
+    typedef enum
+    {
+        LEGACY = 0,
+        V1     = 1
+    } Protocol_t;
+
+    static const int MAX_FRAME   = 32;
+    static const int HISTORY     = 64;     // Commands awaiting an ack, older ones count as lost
+    static const int MAX_RECEIVE   = 4096;   // Longest buf for Extract()
+
+    struct Command_t{
+        float   velocity[3];    // Command frame (cm/s, angular units)
+        float   accel[3];       // Feedforward (per s)
+        bool    has_accel;
+        uint8_t lamp;
+        uint8_t status;
+    };
+
+    struct Stats_t{
+        uint64_t    sent;
+        uint64_t    acked;
+        uint64_t    lost;               // Never acked within HISTORY commands
+        uint64_t    rejected;           // Frames from the firmware failing the CRC or unknown
+        uint64_t    firmware_missed;    // Sequence gaps and bad frames reported by the firmware
+        double      rtt_last;           // Command to ack (s)
+        double      rtt_mean;
+        double      rtt_max;
+    };
+
+    CommandLink();
+
+    void        SetProtocol     (Protocol_t protocol);
+    Protocol_t  Protocol        () const;
+
+    // "legacy" or "v1"
+    static bool ParseProtocol   (const std::string &name, Protocol_t &protocol);
+    static const char* ProtocolName (Protocol_t protocol);
+
+    // Frame for a command sent at time now (s), returns its length
+    int         Encode          (const Command_t &command, double now, uint8_t frame[MAX_FRAME]);
+
+    // Take ack frames received at time now out of buf, returns the bytes left; a frame cut at
+    // the end of buf is held back and completed by the next call. A held back header that turns
+    // out not to be a frame comes back as text, so the result can exceed length; at most
+    // capacity bytes are written to buf and any text beyond that is dropped
+    int         Extract         (uint8_t* buf, int length, int capacity, double now);
+
+    Stats_t     GetStats        (bool reset);
+
+    static uint16_t Crc16       (const uint8_t* data, int length);
+
+private:
+    Protocol_t  protocol;
+    uint16_t    seq;
+
+    // Send Time of Recent Commands by seq % HISTORY
+    uint16_t    sent_seq[HISTORY];
+    double      sent_time[HISTORY];
+    bool        pending[HISTORY];
+
+    uint8_t     carry[MAX_FRAME];
+    int         carry_length;
+    uint8_t     stream[MAX_FRAME + MAX_RECEIVE];
+
+    Stats_t     stats;
+    double      rtt_sum;
+
+    void        HandleAck       (const uint8_t* payload, double now);
+};
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef CONTROL_CORE_H
+#define CONTROL_CORE_H
+
+#include <stdint.h>
+#include <string>
+
+#include "distance_field.h"
+#include "omni_kinematics.h"
+#include "path_controllers.h"
+#include "path_tracking.h"
+#include "rolling_bit_grid.h"
+#include "scan_collision.h"
+#include "speed_governor.h"
+
+// Mode state machine, path tracking and controller selection of the main controller, without ROS.
+// The caller fills Input_t, calls Step() once per tick and forwards Output_t; Step() does not
+// allocate, so its cost per tick is bounded by the selected controller.
+class ControlCore
+{
+public:
+    static const int NUM_BUTTONS = 18;
+    static const int NUM_AXES    = 4;
+
+    typedef enum
+    {
+        SQUARE    = 0,
+        TRIANGLE  = 1,
+        CIRCLE    = 2,
+        CROSS     = 3,
+        L1        = 4,
+        L2        = 5,
+        R1        = 6,
+        R2        = 7,
+        SHARE     = 8,
+        OPTIONS   = 9,
+        DPadLeft  = 14,
+        DPadUp    = 15,
+        DPadRight = 16,
+        DPadDown  = 17
+    } DS4_Button;
+
+    struct Config_t{
+        bool    use_path_spline;
+        float   lookahead;              // Pure pursuit offset at max_speed (m), longer when the governor allows more
+        float   mpc_reference_speed;    // MPC reference progress at max_speed (m/s), scaled like lookahead
+        int     max_speed;              // Command limit per axis, translation limit without the governor (cm/s)
+        bool    use_speed_governor;     // Translation limit from clearance, curvature and localization
+        SpeedGovernor::Config_t governor;
+        bool    use_wheel_limit;        // Scale the whole command when a wheel would saturate
+        OmniKinematics::Config_t kinematics;
+        float   rumble_duration;        // (s)
+        bool    scan_guard_manual;      // Also check joystick commands against the scan
+        float   grid_check_time;        // Stop when the footprint this far ahead hits the grid (s)
+        float   footprint_radius;       // Taken off the static map distance for the governor (m)
+        PathControllerConfig_t controllers;
+    };
+
+    struct Input_t{
+        uint8_t         buttons[NUM_BUTTONS];
+        float           axes[NUM_AXES];
+        TrackingPose_t  pose;               // Map pose of the robot
+        TrackingPath_t* path;               // New path to track or NULL, swapped with the current one
+        bool            obstacle;
+        bool            crashed;
+        TrackingPose_t  obstacle_vel;       // Avoidance velocity while obstacle is set
+        const ScanCollisionChecker* scan;   // Latest scan, NULL when missing or stale
+        const RollingBitGrid* grid;         // Obstacles around the robot in odom, NULL when not kept
+        TrackingPose_t  odom_pose;          // Odom pose of the robot, frame of grid
+        const DistanceField* clearance_map; // Static map distance field in the map frame, NULL when not loaded
+        float           position_std;       // Map position uncertainty from AMCL (m)
+    };
+
+    struct Output_t{
+        int16_t         command[3];         // ControllerData data
+        float           velocity[3];        // Same command before truncation (cm/s, angular units)
+        float           accel[3];           // Change of velocity over the last tick, feedforward (per s)
+        uint8_t         status_control;
+        float           led[3];             // R, G, B intensity
+        float           rumble;
+        TrackingPose_t  target;             // Last pure pursuit target
+        TrackingPose_t  local_desired_vel;  // Tracking command in base_link (x forward, y left)
+        bool            go_home;            // Goal at the origin requested
+        bool            reset_odom;         // Local odometry reset requested
+        bool            path_finished;
+        bool            controller_switched;  // Deferred controller request applied
+        float           collision_scale;    // Applied by the scan check, 1 when unrestricted
+        float           time_to_collision;  // Of the command before scaling (s)
+        bool            grid_blocked;       // Stopped because the grid is occupied ahead
+        float           speed_limit;        // Translation limit applied this tick (cm/s)
+        float           wheel_scale;        // Applied by the wheel limit, 1 when unrestricted
+        bool            keep_ticking;       // Tracking or timing feedback, more ticks needed
+    };
+
+    ControlCore();
+
+    void    Configure           (const Config_t &config);
+    static  Config_t DefaultConfig ();
+
+    // Takes effect now, or after the current run when tracking a path; false for an unknown name
+    bool    RequestController   (const std::string &name);
+    const char* ControllerName  () const;
+
+    const Output_t& Step        (const Input_t &input, float dt);
+
+    bool    Tracking            () const;
+
+private:
+    Config_t            Config;
+    Output_t            Output;
+
+    SpeedGovernor       Governor;
+    OmniKinematics      Kinematics;
+    PathController_t    Tracker;
+    PathController_t    Requested;
+    bool                switch_pending;
+    TrackingInput_t     TrackingInput;
+    TrackingPath_t      path;
+
+    uint8_t StatusControl;
+    uint8_t GuidedMode;
+    uint8_t prev_button[NUM_BUTTONS];
+    bool    rumble_status;
+    bool    prev_crashed;
+    bool    was_tracking;
+    double  clock;              // Time since start from accumulated dt (s)
+    double  rumble_start;
+    double  control_dt;         // Time since the last tracking command (s)
+    float   pace_scale;         // Governed limit over max_speed from the last tick, at least 1
+
+    TrackingPose_t PurePursuit  (TrackingPose_t robot_pose, bool obstacle);
+    void    StartRumble         ();
+    bool    GridPathFree        (const Input_t &input, const float robot_vel[3]) const;
+    float   SpeedLimit          (const Input_t &input, const float robot_vel[3]) const;
+    bool    Released            (const Input_t &input, DS4_Button button) const;
+    bool    Pressed             (const Input_t &input, DS4_Button button) const;
+};
+
+#endif
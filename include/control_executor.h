@@ -0,0 +1,73 @@
+#ifndef CONTROL_EXECUTOR_H
+#define CONTROL_EXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <stdint.h>
+#include <time.h>
+
+// Runs a control tick on an absolute-deadline timer in its own thread and keeps loop timing statistics.
+// In event mode an idle tick (returns false) parks the thread until Notify() or the keep-alive period.
+class ControlExecutor
+{
+public:
+    typedef enum
+    {
+        SKIP     = 0,   // Drop the missed periods and realign to the next deadline
+        CATCH_UP = 1    // Run the missed ticks back to back until on schedule again
+    } Overrun_Policy;
+
+    // All times in microseconds, collected since the last GetStats(true)
+    struct Stats_t{
+        uint64_t ticks;
+        uint64_t missed;
+        uint64_t skipped;
+        uint64_t idle_wakeups;
+        double   period_mean;
+        double   period_min;
+        double   period_max;
+        double   compute_mean;
+        double   compute_max;
+        double   jitter_max;
+    };
+
+    ControlExecutor();
+
+    ~ControlExecutor();
+
+    bool    Start       (double rate_hz, Overrun_Policy policy, std::function<bool()> tick, int priority = 0);
+    void    Stop        ();
+    void    EventMode   (bool enable, double keep_alive);
+    void    Notify      ();
+    Stats_t GetStats    (bool reset);
+
+private:
+    // Catch up at most this many periods before resynchronizing
+    static const int MAX_CATCH_UP = 10;
+
+    std::thread             Worker;
+    std::atomic<bool>       Running;
+    std::atomic<bool>       Pending;
+    std::mutex              StatsMutex;
+    std::mutex              WakeMutex;
+    std::condition_variable WakeCond;
+    std::function<bool()>   Tick;
+
+    bool            EventDriven;
+    double          KeepAlive;
+
+    int64_t         PeriodNs;
+    Overrun_Policy  Policy;
+    Stats_t         Stats;
+    double          PeriodSum;
+    uint64_t        PeriodCount;
+    double          ComputeSum;
+
+    void Loop       ();
+    void ResetStats ();
+};
+
+#endif
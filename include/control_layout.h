@@ -3,6 +3,8 @@
 #include <ros/package.h>
 
 #include "std_msgs/Bool.h"
+#include "std_msgs/String.h"
+#include "std_msgs/UInt32.h"
 #include "std_msgs/Int32MultiArray.h"
 #include "std_msgs/Float32MultiArray.h"
 
@@ -15,19 +17,34 @@
 #include <nav_msgs/Path.h>
 
 #include <sensor_msgs/Joy.h>
+#include <sensor_msgs/LaserScan.h>
 #include <sensor_msgs/BatteryState.h>
 #include <sensor_msgs/JoyFeedback.h>
 #include <sensor_msgs/JoyFeedbackArray.h>
 
 #include <tf/transform_broadcaster.h>
 #include "main_controller/ControllerData.h"
+#include "main_controller/LoopStats.h"
+#include "control_executor.h"
+#include "throttled_publisher.h"
+#include "path_spline.h"
+#include "pose_predictor.h"
+#include "path_controllers.h"
+#include "path_tracking.h"
+#include "control_core.h"
+#include "scan_collision.h"
+#include "rolling_bit_grid.h"
+#include "distance_field.h"
+#include "path_shortcut.h"
 
 
 //STD-Libraries
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <queue>
 #include <array>
+#include <mutex>
 #include "stdio.h"
 #include "stdlib.h"
 
@@ -43,58 +60,36 @@ public:
     ~Robot();
 
 private:
-    int     robot_vel[3]       = {0, 0, 0};
-    uint8_t StatusControl      = 0;
-    uint8_t GuidedMode         = 0;
-    bool    rumble_status;   
-    bool    obstacle_status, crashed_status, prev_crashed; 
-
-    struct DS4_t 
-    {
-        uint8_t Buttons[18];
-        float   Axis[4] = {0, 0, 0, 0};
-        uint8_t prev_button[18];
-    };
-
-    struct Path_t{
-        std::queue<float> x;
-        std::queue<float> y;
-        std::queue<float> theta;
-    };
-
-    struct Pose_t{
-        float x;
-        float y;
-        float theta;
-    };
-
-    typedef enum
-    {
-        SQUARE    = 0,
-        TRIANGLE  = 1,
-        CIRCLE    = 2,
-        CROSS     = 3,
-        L1        = 4,
-        L2        = 5,
-        R1        = 6,
-        R2        = 7,
-        SHARE     = 8,
-        OPTIONS   = 9,
-        DPadLeft  = 14,
-        DPadUp    = 15,
-        DPadRight = 16,
-        DPadDown  = 17
-    } DS4_Button;
-    
-    DS4_t Controller;
-    Path_t path;
-    Pose_t robot_pose;
-    Pose_t robot_pose_odom;
-    Pose_t next_pose;
-
-    Pose_t local_vel;
-    Pose_t pure_pursuit_vel;
-    Pose_t obstacle_avoider_vel;
+    bool    use_path_spline;
+    bool    use_pose_predictor;
+    bool    use_scan_check;
+    bool    use_grid_check;
+    bool    path_pending = false;
+    double  scan_timeout;
+
+    typedef TrackingPath_t Path_t;
+
+    typedef TrackingPose_t Pose_t;
+
+    ControlCore             Core;
+    ControlCore::Input_t    CoreInput;
+    Path_t                  pending_path;
+    Pose_t                  robot_pose;
+    Pose_t                  robot_pose_odom;
+    PosePredictor           Predictor;
+    ScanCollisionChecker    Checker;
+    RollingBitGrid          Grid;
+    RollingBitGrid          ScanGrid;               // Updated by the scan callback outside StateMutex
+    RollingBitGrid::Pose_t  laser_offset;
+    DistanceField           MapClearance;
+    bool                    use_map_clearance = false;
+    PathShortcut            Shortcut;
+    bool                    use_path_shortcut = false;
+    std::vector<PathShortcut::Point_t>  raw_path;
+    std::vector<PathShortcut::Point_t>  short_path;
+    ros::Time               scan_time;
+    ros::Time               input_stamp;        // Oldest input not yet seen by a tick, zero when none
+    uint32_t                command_seq = 0;
 
     ros::NodeHandle     Nh;
     ros::Subscriber     Sub_Joy;
@@ -105,14 +100,25 @@ private:
     ros::Subscriber     Sub_Crashed;
     ros::Subscriber     Sub_Obstacle;
     ros::Subscriber     Sub_Obs_Vel;
+    ros::Subscriber     Sub_Set_Controller;
+    ros::Subscriber     Sub_Scan;
     
-    ros::Publisher      Pub_Vel;
-    ros::Publisher      Pub_Joy_Feedback;
     ros::Publisher      Pub_Origin;
-    ros::Publisher      Pub_Pure_Pursuit;
-    ros::Publisher      Pub_Local_Desired_Vel;
-    ros::Rate           RosRate;
-    ros::Time           prev_time;
+
+    ThrottledPublisher<main_controller::ControllerData>     Pub_Vel;
+    ThrottledPublisher<sensor_msgs::JoyFeedbackArray>       Pub_Joy_Feedback;
+    ThrottledPublisher<geometry_msgs::PoseStamped>          Pub_Pure_Pursuit;
+    ThrottledPublisher<geometry_msgs::Twist>                Pub_Local_Desired_Vel;
+    ros::Publisher      Pub_Loop_Stats;
+    ros::Timer          Timer_Loop_Stats;
+    ros::Publisher      Pub_Heartbeat;
+    ros::Timer          Timer_Heartbeat;
+    double              heartbeat_tick_timeout;
+    std_msgs::UInt32    heartbeat_msg;
+    ros::Time           prev_tick_time;
+
+    ControlExecutor     Executor;
+    std::mutex          StateMutex;
 
     sensor_msgs::JoyFeedback        MsgJoyLED_R;
     sensor_msgs::JoyFeedback        MsgJoyLED_G;
@@ -124,13 +130,10 @@ private:
     geometry_msgs::Twist            local_desired_vel_msg;
 
     main_controller::ControllerData         vel_msg;
+    main_controller::LoopStats              loop_stats_msg;
 
-    void ClearPath                (Path_t &path);
-    Pose_t PurePursuit            (Pose_t robotPose, Path_t &path, float offset, bool obstacle);
-    Pose_t PointToPointPID        (Pose_t robotPose, Pose_t targetPose);
-    Pose_t PointToPointPIDV2      (Pose_t robot_pose, Pose_t target_pose);
-    Pose_t PointToPointLQR        (Pose_t robotPose, Pose_t targetPose, float maxSpeed);
-    Pose_t Global_to_Local_Vel    (Pose_t robot_pose, Pose_t global_vel);
+    bool ControlTick              ();
+    void Loop_Stats_Event         (const ros::TimerEvent &event);
     
     void Joy_Callback             (const sensor_msgs::Joy::ConstPtr &joy_msg);
     void Path_Callback            (const nav_msgs::Path::ConstPtr &path_msg);
@@ -139,4 +142,8 @@ private:
     void Crashed_Status_Callback  (const std_msgs::Bool::ConstPtr &crashed_msg);
     void Obstacle_Status_Callback (const std_msgs::Bool::ConstPtr &obs_status_msg);
     void Obstacle_Vel_Callback    (const geometry_msgs::Twist::ConstPtr &obs_vel_msg);
+    void Mark_Input_Stamp         (const ros::Time &stamp);
+    void Heartbeat_Event          (const ros::TimerEvent &event);
+    void Set_Controller_Callback  (const std_msgs::String::ConstPtr &controller_msg);
+    void Scan_Callback            (const sensor_msgs::LaserScan::ConstPtr &scan_msg);
 };
\ No newline at end of file
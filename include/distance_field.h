@@ -0,0 +1,59 @@
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "occupancy_map.h"
+
+// Exact Euclidean distance from every cell centre to the nearest obstacle cell centre, in meters.
+// Computed separably in linear time: a scan down and up every column gives the distance within
+// the column, then the lower envelope transform of Felzenszwalb and Huttenlocher runs along
+// every row. Both passes are split across threads.
+// Results are cached in a file next to the map and reused while the map is unchanged.
+class DistanceField
+{
+public:
+    static const float NO_OBSTACLE;     // Distance reported when the map has no obstacle at all
+
+    DistanceField();
+
+    // obstacle holds width * height flags, row 0 at origin_y; threads <= 0 uses every core
+    void    Compute         (const uint8_t* obstacle, int width, int height, float resolution,
+                             float origin_x, float origin_y, int threads);
+    void    Compute         (const OccupancyMap &map, bool unknown_is_obstacle, int threads);
+
+    // Reuse cache_path when it was built from the same map, otherwise compute and rewrite it
+    bool    LoadOrCompute   (const OccupancyMap &map, const std::string &cache_path,
+                             bool unknown_is_obstacle, int threads, bool &from_cache);
+    bool    Save            (const std::string &cache_path, uint64_t source_hash) const;
+    bool    Load            (const std::string &cache_path, uint64_t source_hash);
+
+    // Fingerprint of the cells and geometry a field is computed from
+    static  uint64_t SourceHash (const OccupancyMap &map, bool unknown_is_obstacle);
+    // maps/katk.yaml -> maps/katk.edt
+    static  std::string CachePath (const std::string &yaml_path);
+
+    // Distance of a cell, 0 outside the field (m)
+    float   Distance        (int cx, int cy) const;
+    // Distance of the cell containing a world point, 0 outside the field (m)
+    float   Clearance       (float x, float y) const;
+
+    int     Width           () const;
+    int     Height          () const;
+    float   Resolution      () const;
+    float   OriginX         () const;
+    float   OriginY         () const;
+    const std::vector<float>& Data () const;
+
+private:
+    int     width;
+    int     height;
+    float   resolution;
+    float   origin_x;
+    float   origin_y;
+    std::vector<float> distance;
+};
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef DSTAR_LITE_H
+#define DSTAR_LITE_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "grid_planner.h"
+
+// Incremental replanning with D* Lite (Koenig and Likhachev) on a copy of the FreeGrid of a
+// GridPlanner, same 8-connected moves and corner rule; added obstacles block cells in the copy.
+// The search runs backwards from the goal and keeps g and rhs of every cell between updates,
+// so when cells get blocked only the part of the tree whose costs changed is repaired. The open
+// list is a binary heap with lazy removal: stale entries are recognised by their key and
+// skipped when they reach the top.
+class DStarLite
+{
+public:
+    struct Stats_t{
+        int     expanded;               // Vertices taken from the open list by the last update
+        int     pushed;                 // Heap insertions since the last Start or AddObstacles
+        int     changed;                // Cells blocked by the last AddObstacles
+    };
+
+    DStarLite();
+
+    // Copy of the free cells and geometry, drops any search
+    void    SetMap          (const GridPlanner &planner);
+
+    // Full search from goal to start, both free cell indices
+    bool    Start           (int start, int goal);
+    bool    Active          () const;
+
+    // Drop the search once its goal is reached or abandoned, Replan fails until the next Start
+    void    Stop            ();
+
+    // Block every cell within radius of each world point, true when a free cell got blocked
+    bool    AddObstacles    (const std::vector<GridPlanner::Point_t> &points, float radius);
+
+    // Repair the tree after the robot moved to start and obstacles were added, then follow it;
+    // a blocked start leaves from the nearest free cell, which is then the first entry
+    bool    Replan          (int start, std::vector<int> &cells);
+
+    bool    Free            (int cx, int cy) const;
+    int     Goal            () const;
+    const Stats_t& Stats    () const;
+
+private:
+    struct Key_t{
+        float   k1;
+        float   k2;
+
+        bool operator<(const Key_t &other) const
+        {
+            return k1 < other.k1 || (k1 == other.k1 && k2 < other.k2);
+        }
+    };
+
+    struct HeapEntry_t{
+        Key_t   key;
+        int32_t cell;
+    };
+
+    FreeGrid    grid;
+    int         width;              // Of the grid, kept for the search loops
+    int         height;
+
+    bool        active;
+    int         start;
+    int         last;               // Start when km was last updated
+    int         goal;
+    float       km;
+    Stats_t     stats;
+
+    std::vector<float>          g;
+    std::vector<float>          rhs;
+    std::vector<Key_t>          queued;         // Key of the live heap entry of each cell
+    std::vector<uint8_t>        in_queue;
+    std::vector<HeapEntry_t>    heap;
+    std::vector<int>            dirty;
+
+    float   Heuristic       (int a, int b) const;
+    float   Cost            (int from, int dx, int dy) const;
+    Key_t   CalculateKey    (int cell) const;
+    void    Push            (int cell, const Key_t &key);
+    void    UpdateVertex    (int cell);
+    float   BestSuccessor   (int cell, int* next) const;
+    void    ComputeShortestPath ();
+    void    Block           (int cx, int cy);
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef FREE_GRID_H
+#define FREE_GRID_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Free cells of a stored map, one bit per cell, shared by GridPlanner, DStarLite and
+// PathShortcut. A cell is free when its centre is at least the inflation radius away from the
+// edge of every obstacle cell, so inflation is a threshold on the distance field rather than a
+// costmap pass. Also holds the 8-connected moves, their octile length and the heap order the
+// grid searches share.
+class FreeGrid
+{
+public:
+    struct Point_t{
+        float x;
+        float y;
+    };
+
+    static const float  SQRT2;
+    static const int    DIRECTION_X[8];
+    static const int    DIRECTION_Y[8];
+
+    // Min-Heap Order on the key Member for std::push_heap and std::pop_heap
+    struct HeapAfter_t{
+        template <typename Entry>
+        bool operator()(const Entry &a, const Entry &b) const
+        {
+            return b.key < a.key;
+        }
+    };
+
+    FreeGrid();
+
+    // distance holds the distance of each cell centre to the nearest obstacle cell centre (m)
+    void    Build           (const float* distance, int width, int height, float resolution,
+                             float origin_x, float origin_y, float inflation_radius);
+    bool    Empty           () const;
+
+    bool    Free            (int cx, int cy) const;
+    void    Block           (int cx, int cy);
+    bool    WorldToCell     (float x, float y, int &cx, int &cy) const;
+    Point_t CellCenter      (int cell) const;
+
+    // Closest free cell within max_ring cells by Euclidean distance, searched ring by ring; -1 when none
+    int     NearestFree     (int cx, int cy, int max_ring) const;
+
+    // Length of the shortest 8-connected move sequence over dx, dy cells, ignoring obstacles
+    static  float Octile    (int dx, int dy);
+
+    int     Width           () const;
+    int     Height          () const;
+    float   Resolution      () const;
+    float   OriginX         () const;
+    float   OriginY         () const;
+
+private:
+    int         width;
+    int         height;
+    int         words;              // 64-bit words per row
+    float       resolution;
+    float       origin_x;
+    float       origin_y;
+    std::vector<uint64_t> bits;
+};
+
+// Inline, the Searches Test Every Neighbour
+inline bool FreeGrid::Free(int cx, int cy) const
+{
+    if((unsigned)cx >= (unsigned)width || (unsigned)cy >= (unsigned)height)
+    {
+        return false;
+    }
+    return (bits[(size_t)cy * words + (cx >> 6)] >> (cx & 63)) & 1;
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef GRID_PLANNER_H
+#define GRID_PLANNER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "distance_field.h"
+#include "free_grid.h"
+#include "map_file.h"
+
+// Shortest 8-connected paths on a stored map without ROS, over the free cells of a FreeGrid at
+// the inflation radius. Diagonal steps never cut an occupied corner. A* expands every
+// neighbour, Jump Point Search jumps along straight and diagonal runs and only queues the
+// points where the run can turn. Both use a binary heap and per-cell arrays that stay allocated
+// between queries, cleared lazily with a query generation number.
+class GridPlanner
+{
+public:
+    typedef enum
+    {
+        ASTAR = 0,
+        JPS   = 1
+    } Algorithm_t;
+
+    struct Config_t{
+        Algorithm_t algorithm;
+        float   inflation_radius;       // Cells closer than this to the edge of an obstacle cell are blocked (m)
+        float   snap_distance;          // Start or goal in a blocked cell moves to the nearest free cell within this (m)
+    };
+
+    typedef FreeGrid::Point_t Point_t;
+
+    struct Stats_t{
+        int     expanded;               // Nodes taken from the open list
+        int     pushed;                 // Heap insertions
+        float   length;                 // Path length (m)
+        bool    start_snapped;
+        bool    goal_snapped;
+    };
+
+    GridPlanner();
+
+    void    Configure       (const Config_t &config);
+    const Config_t& Config  () const;
+    static  bool ParseAlgorithm (const std::string &name, Algorithm_t &algorithm);
+    static  const char* AlgorithmName (Algorithm_t algorithm);
+
+    // Rebuild the free cell bits, after a map change or a new inflation radius
+    void    SetMap          (const float* distance, int width, int height, float resolution,
+                             float origin_x, float origin_y);
+    void    SetMap          (const DistanceField &field);
+    void    SetMap          (const MapFile &file);
+
+    // Path from start to goal in world coordinates, cell centres one cell apart; false when unreachable
+    bool    Plan            (float start_x, float start_y, float goal_x, float goal_y, std::vector<Point_t> &path);
+    // Same on cell indices (y * width + x), first entry start and last entry goal
+    bool    PlanCells       (int start, int goal, std::vector<int> &cells);
+
+    bool    Free            (int cx, int cy) const;
+    bool    WorldToCell     (float x, float y, int &cx, int &cy) const;
+    Point_t CellCenter      (int cell) const;
+    int     Width           () const;
+    int     Height          () const;
+    float   Resolution      () const;
+    const FreeGrid& Grid    () const;
+    const Stats_t& Stats    () const;
+
+private:
+    struct HeapEntry_t{
+        float   key;                // f = g + h
+        int32_t cell;
+    };
+
+    Config_t    config;
+    Stats_t     stats;
+    int         width;              // Of the grid, kept for the search loops
+    int         height;
+    std::vector<float>  distance;   // Kept to rebuild the grid for a new inflation radius
+    FreeGrid            grid;
+
+    // Search Arena, Reused Across Queries
+    uint32_t                    generation;
+    std::vector<uint32_t>       state;          // generation << 1 | closed
+    std::vector<float>          g;
+    std::vector<int32_t>        parent;
+    std::vector<HeapEntry_t>    heap;
+    std::vector<int>            cell_path;
+
+    void    BuildGrid       ();
+    void    NewQuery        ();
+    bool    Open            (int cell, float cost, int from, float h);
+    bool    SearchAStar     (int start, int goal);
+    bool    SearchJPS       (int start, int goal);
+    int     Jump            (int x, int y, int dx, int dy, int gx, int gy) const;
+};
+
+#endif
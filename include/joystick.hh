@@ -149,6 +149,12 @@ public:
    * from the joystick. Returns true if data is available, otherwise false.
    */
   bool sample(JoystickEvent* event);
+
+  /**
+   * Returns the file descriptor of the device, or a negative value if it
+   * could not be opened. Lets callers wait for events with poll().
+   */
+  int fileDescriptor() const;
 };
 
 #endif
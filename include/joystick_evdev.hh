@@ -0,0 +1,87 @@
+#ifndef __JOYSTICK_EVDEV_HH__
+#define __JOYSTICK_EVDEV_HH__
+
+#include <stdint.h>
+#include <deque>
+#include <string>
+
+#include "joystick.hh"
+
+/**
+ * A joystick event read through evdev, with the kernel timestamp kept.
+ */
+class JoystickEvdevEvent : public JoystickEvent
+{
+public:
+  /**
+   * The kernel timestamp of the event in microseconds since the epoch
+   * (CLOCK_REALTIME, comparable with ros::Time::now()). Initial state
+   * events carry the time the device was opened.
+   */
+  uint64_t timeMicros;
+};
+
+/**
+ * Reads a joystick from /dev/input/event* with the same interface as
+ * Joystick. Buttons and axes are numbered the way the kernel joydev driver
+ * numbers them for /dev/input/js*, and axis values are scaled to
+ * JoystickEvent::MIN_AXES_VALUE..MAX_AXES_VALUE with the device dead zone,
+ * so both backends produce the same events apart from the timestamps.
+ */
+class JoystickEvdev
+{
+private:
+  void openPath(std::string devicePath, bool blocking);
+  void queueInitialState();
+
+  int _fd;
+
+  // evdev code to joydev number, -1 for codes the device does not have
+  int _buttonNumber[0x300];
+  int _axisNumber[0x40];
+  int _buttonCount;
+  int _axisCount;
+
+  // Axis range from EVIOCGABS
+  int _axisMin[0x40];
+  int _axisMax[0x40];
+  int _axisFlat[0x40];
+
+  std::deque<JoystickEvdevEvent> _initial;
+
+  short scaleAxis(int code, int value) const;
+
+public:
+  ~JoystickEvdev();
+
+  /**
+   * Initialises an instance for the evdev device specified, for example
+   * /dev/input/by-id/usb-..-event-joystick, optionally with blocking I/O.
+   */
+  JoystickEvdev(std::string devicePath, bool blocking=false);
+
+  JoystickEvdev(JoystickEvdev const&) = delete;
+
+  /**
+   * Returns true if the device was opened and reports at least one button
+   * or axis, otherwise false.
+   */
+  bool isFound();
+
+  /**
+   * Attempts to populate the provided event with the next button or axis
+   * change. The initial state of every button and axis is returned first,
+   * flagged with JS_EVENT_INIT. Returns true if an event was available.
+   */
+  bool sample(JoystickEvdevEvent* event);
+
+  /**
+   * Returns the file descriptor of the device for use with poll().
+   */
+  int fileDescriptor() const;
+
+  int buttonCount() const;
+  int axisCount() const;
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+
+// Fixed log-spaced latency histogram: bin k holds samples up to FIRST_EDGE * 2^k microseconds,
+// the last bin everything longer. Adding a sample is a handful of compares and never allocates.
+class LatencyHistogram
+{
+public:
+    static const int    BINS = 14;
+    static const float  FIRST_EDGE;         // Upper edge of the first bin (us)
+
+    LatencyHistogram();
+
+    // Latency in seconds, negative values (clock steps) count as zero
+    void        Add             (double latency);
+    void        Reset           ();
+
+    static float BinEdge        (int bin);  // (us)
+    uint32_t    Count           (int bin) const;
+    uint64_t    Samples         () const;
+    float       Mean            () const;   // (us)
+    float       Max             () const;   // (us)
+
+private:
+    uint32_t    counts[BINS];
+    uint64_t    samples;
+    double      sum;
+    double      max;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef MAP_FILE_H
+#define MAP_FILE_H
+
+#include <stdint.h>
+#include <string>
+
+#include "distance_field.h"
+#include "occupancy_map.h"
+
+// Binary map container opened with mmap, read-only and shared between processes. One file
+// holds every layer of a map, each 64-byte aligned and used in place:
+//   cells      int8 per cell, FREE / OCCUPIED / UNKNOWN as in nav_msgs/OccupancyGrid
+//   bits       obstacle bit per cell, rows of 64-bit words
+//   distance   float per cell, distance to the nearest obstacle (m)
+//   pyramid    uint8 per cell per level, level l cell is the max of the 2^l x 2^l block below
+// Row 0 is at origin_y. Files are written on the host that reads them, no byte swapping.
+class MapFile
+{
+public:
+    static const int MAX_LEVELS = 16;
+
+    struct Level_t{
+        int32_t     width;
+        int32_t     height;
+        uint64_t    offset;
+    };
+
+    struct Header_t{
+        char        magic[8];
+        uint32_t    version;
+        uint32_t    header_size;
+        int32_t     width;
+        int32_t     height;
+        float       resolution;
+        float       origin_x;
+        float       origin_y;
+        uint32_t    unknown_is_obstacle;
+        uint32_t    words_per_row;
+        uint32_t    levels;
+        uint64_t    source_hash;            // DistanceField::SourceHash of the map
+        uint64_t    cells_offset;
+        uint64_t    bits_offset;
+        uint64_t    distance_offset;
+        uint64_t    file_size;
+        Level_t     level[MAX_LEVELS];
+    };
+
+    MapFile();
+    ~MapFile();
+    MapFile(const MapFile&) = delete;
+    MapFile& operator=(const MapFile&) = delete;
+
+    // Converter, field must be computed from map with the same unknown_is_obstacle
+    static bool Write       (const std::string &path, const OccupancyMap &map, const DistanceField &field,
+                             bool unknown_is_obstacle, std::string &error);
+    // maps/katk.yaml -> maps/katk.bmap
+    static std::string PathFor (const std::string &yaml_path);
+
+    bool    Open            (const std::string &path, std::string &error);
+    void    Close           ();
+    bool    IsOpen          () const;
+
+    int     Width           () const;
+    int     Height          () const;
+    float   Resolution      () const;
+    float   OriginX         () const;
+    float   OriginY         () const;
+    const Header_t& Header  () const;
+
+    bool    WorldToCell     (float x, float y, int &cx, int &cy) const;
+
+    const int8_t*   Cells       () const;
+    const uint64_t* Bits        () const;
+    int             WordsPerRow () const;
+    bool            Occupied    (int cx, int cy) const;     // Outside the map counts as occupied
+    const float*    Distance    () const;
+    float           Clearance   (float x, float y) const;   // 0 outside the map (m)
+
+    int             Levels      () const;                   // Level 0 is the full resolution
+    int             LevelWidth  (int level) const;
+    int             LevelHeight (int level) const;
+    const uint8_t*  Level       (int level) const;
+    // Any obstacle in the block of level cells containing full resolution cell (cx, cy)
+    bool            BlockOccupied (int level, int cx, int cy) const;
+
+private:
+    const unsigned char*    data;
+    size_t                  size;
+    const Header_t*         header;
+};
+
+#endif
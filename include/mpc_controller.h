@@ -0,0 +1,79 @@
+#ifndef MPC_CONTROLLER_H
+#define MPC_CONTROLLER_H
+
+#include <Eigen/Dense>
+
+// Model predictive path tracker for the holonomic base. Each axis (x, y, theta) is an
+// integrator in the map frame, so the QP splits into three HORIZON-sized problems with
+// hard speed and acceleration bounds, solved by warm-started ADMM with a capped iteration count.
+class MpcController
+{
+public:
+    static const int HORIZON = 10;
+
+    struct Pose_t{
+        float x;
+        float y;
+        float theta;
+    };
+
+    struct Config_t{
+        float dt;                   // Prediction step (s)
+        float q_position;           // Weight on position error (1/m^2)
+        float q_theta;              // Weight on heading error (1/rad^2)
+        float r_speed;              // Weight on command magnitude
+        float r_accel;              // Weight on command change
+        float max_speed;            // Linear command bound (cm/s)
+        float max_angular;          // Angular command bound (command units)
+        float max_accel;            // Linear acceleration bound (cm/s^2)
+        float max_angular_accel;    // Angular acceleration bound (command units/s)
+        float angular_scale;        // Angular command units per rad/s
+        float rho;                  // ADMM penalty
+        int   max_iterations;
+    };
+
+    MpcController();
+
+    void    Configure   (const Config_t &config);
+    void    Reset       ();
+
+    // reference[k] is the desired map pose after k + 1 steps, tick_dt the time since the last command.
+    // Returns the map-frame command: x, y in cm/s and theta in angular command units.
+    Pose_t  Compute     (const Pose_t &robot_pose, const Pose_t reference[HORIZON], float tick_dt);
+
+    // Linear command bound (cm/s) for the next Compute calls, Config.max_speed when not positive.
+    // Only the ADMM box changes, nothing is refactored.
+    void    SetMaxSpeed (float max_speed);
+
+    int     Iterations  () const;
+
+private:
+    typedef Eigen::Matrix<float, HORIZON, 1>            Vector_t;
+    typedef Eigen::Matrix<float, 2*HORIZON, 1>          Vector2_t;
+    typedef Eigen::Matrix<float, HORIZON, HORIZON>      Matrix_t;
+    typedef Eigen::Matrix<float, 2*HORIZON, HORIZON>    Constraint_t;
+
+    struct Axis_t{
+        Matrix_t    H;          // Cost Hessian
+        Matrix_t    Minv;       // (H + sigma I + rho A'A)^-1
+        Matrix_t    F;          // Linear cost per unit of tracking error
+        Vector_t    x;          // Warm start primal
+        Vector2_t   z;          // Warm start slack
+        Vector2_t   y;          // Warm start dual
+        float       q;
+        float       gain;       // Position change per step per command unit
+        float       max_speed;
+        float       max_accel;
+        float       prev_command;
+    };
+
+    Config_t        Config;
+    Constraint_t    A;
+    Axis_t          Axis[3];
+    int             LastIterations;
+
+    void    Prepare     (Axis_t &axis, float q, float gain, float max_speed, float max_accel);
+    float   Solve       (Axis_t &axis, float position, const Vector_t &reference, float tick_dt);
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef OCCUPANCY_MAP_H
+#define OCCUPANCY_MAP_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Stored map_server map (YAML plus PGM image) without ROS. Cells are classified the way
+// map_server does in trinary mode and stored like nav_msgs/OccupancyGrid: row 0 is the
+// bottom edge of the image, cell (0, 0) has its corner at the origin.
+class OccupancyMap
+{
+public:
+    static const int8_t FREE     = 0;
+    static const int8_t OCCUPIED = 100;
+    static const int8_t UNKNOWN  = -1;
+
+    struct Info_t{
+        std::string image;          // Image path, relative paths resolved against the YAML
+        float   resolution;         // (m/cell)
+        float   origin_x;           // World position of the corner of cell (0, 0) (m)
+        float   origin_y;
+        float   origin_theta;       // Only 0 is supported, like most map_server consumers
+        bool    negate;
+        float   occupied_thresh;
+        float   free_thresh;
+    };
+
+    OccupancyMap();
+
+    // False with a message in error when a file cannot be read or is not supported
+    bool    Load            (const std::string &yaml_path, std::string &error);
+    bool    LoadImage       (const Info_t &info, std::string &error);
+    static  bool ParseYaml  (const std::string &yaml_path, Info_t &info, std::string &error);
+
+    int     Width           () const;
+    int     Height          () const;
+    float   Resolution      () const;
+    float   OriginX         () const;
+    float   OriginY         () const;
+    const Info_t& Info      () const;
+
+    // Cell containing the world point, false when outside the map
+    bool    WorldToCell     (float x, float y, int &cx, int &cy) const;
+    int8_t  At              (int cx, int cy) const;
+    const std::vector<int8_t>& Cells () const;
+
+private:
+    Info_t              info;
+    int                 width;
+    int                 height;
+    std::vector<int8_t> cells;
+};
+
+#endif
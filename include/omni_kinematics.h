@@ -0,0 +1,48 @@
+#ifndef OMNI_KINEMATICS_H
+#define OMNI_KINEMATICS_H
+
+#include <Eigen/Dense>
+
+// Inverse and forward kinematics of the omnidirectional base. Wheels sit on a circle of
+// base_radius at wheel_angle (rad, counter-clockwise from forward) and roll tangentially.
+// Commands are in the robot command frame: [1] forward and -[0] left in cm/s, [2] in
+// angular command units. Saturation scales the whole command so every wheel stays within
+// max_wheel_speed, which keeps the direction of motion and the turn rate ratio.
+class OmniKinematics
+{
+public:
+    static const int MAX_WHEELS = 4;
+
+    struct Config_t{
+        int     wheels;                     // 3 or 4
+        float   wheel_angle[MAX_WHEELS];    // Wheel position around the centre (rad)
+        float   base_radius;                // Centre to wheel contact (m)
+        float   wheel_radius;               // (m)
+        float   max_wheel_speed;            // (rad/s)
+        float   angular_scale;              // Angular command units per rad/s
+    };
+
+    OmniKinematics();
+
+    void    Configure       (const Config_t &config);
+    const Config_t& Config  () const;
+
+    // Wheel speeds in rad/s for a command, wheel has Config().wheels entries
+    void    ToWheels        (const float command[3], float wheel[]) const;
+
+    // Least-squares command for the given wheel speeds, exact for three wheels
+    void    ToCommand       (const float wheel[], float command[3]) const;
+
+    // Scale command in place so no wheel exceeds max_wheel_speed, returns the factor in (0, 1]
+    float   Saturate        (float command[3]) const;
+
+private:
+    typedef Eigen::Matrix<float, MAX_WHEELS, 3> Jacobian_t;
+    typedef Eigen::Matrix<float, 3, MAX_WHEELS> Inverse_t;
+
+    Config_t    Settings;
+    Jacobian_t  Forward;        // Command to wheel speed, unused wheel rows are zero
+    Inverse_t   Backward;       // Pseudo-inverse of Forward
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef OMNI_SIM_H
+#define OMNI_SIM_H
+
+// Kinematic model of the omnidirectional base driven by ControllerData commands.
+// Commands are in the robot command frame: data[1] forward and -data[0] left in cm/s,
+// data[2] in angular command units. The actuators follow the command with a first-order
+// lag and an acceleration limit, odometry drifts by a configurable scale error.
+class OmniBaseSim
+{
+public:
+    struct Pose_t{
+        float x;
+        float y;
+        float theta;
+    };
+
+    struct Config_t{
+        float tau_linear;           // Linear velocity time constant (s)
+        float tau_angular;          // Angular velocity time constant (s)
+        float max_accel;            // Linear acceleration limit (cm/s^2)
+        float max_angular_accel;    // Angular acceleration limit (command units/s)
+        float angular_scale;        // Angular command units per rad/s
+        float odom_scale_error;     // Relative odometry distance error
+    };
+
+    OmniBaseSim();
+
+    void    Configure   (const Config_t &config);
+    void    Reset       (const Pose_t &pose);
+
+    // Advance dt seconds with the given command held
+    void    Step        (const float command[3], float dt);
+
+    Pose_t  Pose        () const;   // Ground truth in the map frame
+    Pose_t  Odom        () const;   // Dead-reckoned pose in the odom frame
+    Pose_t  Velocity    () const;   // Body velocity, x forward and y left in m/s, theta in rad/s
+
+private:
+    Config_t    Config;
+    Pose_t      Truth;
+    Pose_t      OdomPose;
+    float       Vel[3];             // Achieved command-frame velocity
+};
+
+#endif
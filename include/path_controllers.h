@@ -0,0 +1,127 @@
+#ifndef PATH_CONTROLLERS_H
+#define PATH_CONTROLLERS_H
+
+#include <string>
+#include <variant>
+
+#include <Eigen/Dense>
+
+#include "mpc_controller.h"
+
+// Pose (m, rad) or map-frame velocity command (cm/s, angular command units)
+struct TrackingPose_t{
+    float x;
+    float y;
+    float theta;
+};
+
+struct TrackingInput_t{
+    TrackingPose_t robot;
+    TrackingPose_t target;
+    TrackingPose_t horizon[MpcController::HORIZON];   // Only filled for MPC
+    float          dt;                                // Time since last command (s)
+    float          max_speed;                         // Linear bound this tick (cm/s), the controller's own when not positive
+};
+
+// Each controller owns its state; Compute() returns the map-frame velocity command
+class PidController
+{
+public:
+    struct Config_t{
+        float kp[3];
+        float ki[3];
+        float kd[3];
+    };
+
+    PidController();
+    PidController(const Config_t &config);
+
+    void            Reset   ();
+    TrackingPose_t  Compute (const TrackingInput_t &input);
+
+private:
+    Config_t Config;
+    float    prevError[3];
+    float    sumError[3];
+};
+
+class PidV2Controller
+{
+public:
+    struct Config_t{
+        float kp[2];    // Heading, Distance
+        float ki[2];
+        float kd[2];
+    };
+
+    PidV2Controller();
+    PidV2Controller(const Config_t &config);
+
+    void            Reset   ();
+    TrackingPose_t  Compute (const TrackingInput_t &input);
+
+private:
+    Config_t Config;
+    float    prevError[2];
+    float    sumError[2];
+};
+
+class LqrController
+{
+public:
+    struct Config_t{
+        float q_position;
+        float q_theta;
+        float r;
+        float max_speed;
+    };
+
+    LqrController();
+    LqrController(const Config_t &config);
+
+    void            Reset   ();
+    TrackingPose_t  Compute (const TrackingInput_t &input);
+
+private:
+    Config_t        Config;
+    Eigen::Matrix3f K;
+};
+
+class MpcTracker
+{
+public:
+    MpcTracker();
+    MpcTracker(const MpcController::Config_t &config);
+
+    void            Reset   ();
+    TrackingPose_t  Compute (const TrackingInput_t &input);
+
+private:
+    MpcController   Mpc;
+};
+
+// Static dispatch over the available controllers, no virtual calls or allocation per tick
+typedef std::variant<LqrController, PidController, PidV2Controller, MpcTracker> PathController_t;
+
+struct PathControllerConfig_t{
+    PidController::Config_t     pid;
+    PidV2Controller::Config_t   pid_v2;
+    LqrController::Config_t     lqr;
+    MpcController::Config_t     mpc;
+};
+
+PathControllerConfig_t  DefaultPathControllerConfig ();
+bool                    MakePathController          (const std::string &name, const PathControllerConfig_t &config, PathController_t &controller);
+const char*             PathControllerName          (const PathController_t &controller);
+
+inline TrackingPose_t ComputePathController(PathController_t &controller, const TrackingInput_t &input)
+{
+    return std::visit([&input](auto &c) { return c.Compute(input); }, controller);
+}
+
+inline void ResetPathController(PathController_t &controller)
+{
+    std::visit([](auto &c) { c.Reset(); }, controller);
+}
+
+#endif
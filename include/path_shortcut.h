@@ -0,0 +1,73 @@
+#ifndef PATH_SHORTCUT_H
+#define PATH_SHORTCUT_H
+
+#include <vector>
+
+#include "distance_field.h"
+#include "free_grid.h"
+
+// Post-processing of grid planner paths before they are tracked. Staircase runs are replaced by
+// straight segments wherever every cell the line between two path points crosses is free in a
+// FreeGrid, walked with integer steps as in Bresenham. The remaining corners are rounded by
+// corner cutting (Chaikin) where the cut also stays free, and long segments are split again to
+// a maximum spacing. The free cells are those GridPlanner plans on at the same inflation radius,
+// so a path from planner_node is never made worse.
+class PathShortcut
+{
+public:
+    struct Config_t{
+        float   inflation_radius;       // As in GridPlanner::Config_t (m)
+        int     smooth_iterations;      // Corner cutting passes, 0 keeps the shortcut polyline
+        float   corner_cut;             // Longest cut taken off either side of a corner per pass (m)
+        float   max_spacing;            // Longer segments get intermediate points, 0 leaves them (m)
+    };
+
+    struct Point_t{
+        float x;
+        float y;
+        float theta;
+    };
+
+    struct Stats_t{
+        int     input_points;
+        int     output_points;
+        float   input_length;           // (m)
+        float   output_length;          // (m)
+        int     line_checks;            // Line of sight tests
+    };
+
+    PathShortcut();
+
+    void    Configure       (const Config_t &config);
+    const Config_t& Config  () const;
+
+    // Free cells at the configured inflation radius, a new radius applies from the next SetMap
+    void    SetMap          (const float* distance, int width, int height, float resolution,
+                             float origin_x, float origin_y);
+    void    SetMap          (const DistanceField &field);
+    bool    Ready           () const;
+
+    // Shortcut and smooth path into out. Interior points take the heading of their outgoing
+    // segment, the last point keeps its own. Without a map the path is copied unchanged.
+    void    Process         (const std::vector<Point_t> &path, std::vector<Point_t> &out);
+
+    // Every cell the segment between two world points crosses is free, and both side cells where
+    // it passes exactly through a corner so it never slips between two blocked cells
+    bool    LineOfSight     (float x0, float y0, float x1, float y1);
+
+    bool    Free            (int cx, int cy) const;
+    const Stats_t& Stats    () const;
+
+private:
+    Config_t    config;
+    Stats_t     stats;
+    FreeGrid    grid;
+    std::vector<Point_t>    work;
+    std::vector<Point_t>    scratch;
+
+    void    Shortcut        (const std::vector<Point_t> &path, std::vector<Point_t> &out);
+    void    Smooth          (std::vector<Point_t> &points);
+    void    Resample        (const std::vector<Point_t> &points, std::vector<Point_t> &out);
+};
+
+#endif
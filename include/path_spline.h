@@ -0,0 +1,50 @@
+#ifndef PATH_SPLINE_H
+#define PATH_SPLINE_H
+
+#include <vector>
+
+// Continuous path through sparse waypoints (centripetal Catmull-Rom) with arc-length lookup
+class PathSpline
+{
+public:
+    struct Sample_t{
+        float x;
+        float y;
+        float theta;
+    };
+
+    PathSpline();
+
+    void  Fit       (const std::vector<float> &x, const std::vector<float> &y, const std::vector<float> &theta);
+    void  Clear     ();
+    bool  Empty     () const;
+    float Length    () const;
+
+    // Pose at arc length s, clamped to [0, Length()]
+    Sample_t Sample (float s) const;
+
+    // Arc length of the point closest to (x, y), searched in [s_min, s_max]
+    float Project   (float x, float y, float s_min, float s_max) const;
+
+private:
+    // Samples per segment for the arc-length table
+    static const int TABLE_RES = 16;
+
+    struct Segment_t{
+        float ax, bx, cx, dx;
+        float ay, by, cy, dy;
+        float theta0, dtheta;
+    };
+
+    std::vector<Segment_t> segment;
+
+    // Arc-length table, start point plus TABLE_RES entries per segment
+    std::vector<float> table_s;
+    std::vector<float> table_x;
+    std::vector<float> table_y;
+
+    void     Evaluate   (const Segment_t &seg, float u, float &x, float &y) const;
+    Sample_t SampleTable(int idx, float frac) const;
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef PATH_TRACKING_H
+#define PATH_TRACKING_H
+
+#include <queue>
+
+#include "path_spline.h"
+#include "path_controllers.h"
+
+// Remaining waypoints of the path being tracked, plus the fitted curve when spline tracking is on
+struct TrackingPath_t{
+    std::queue<float> x;
+    std::queue<float> y;
+    std::queue<float> theta;
+    PathSpline curve;
+    float progress = 0.0;
+};
+
+// Lookahead target on the waypoint queue, consumed waypoints are popped. finished is set when
+// the last waypoint was reached and removed.
+TrackingPose_t  PurePursuit         (TrackingPose_t robot_pose, TrackingPath_t &path, float offset, bool obstacle, bool &finished);
+
+// Lookahead target on the fitted curve, progress only moves forward
+TrackingPose_t  PurePursuitSpline   (TrackingPose_t robot_pose, TrackingPath_t &path, float offset, bool obstacle, bool &finished);
+
+void            ClearTrackingPath   (TrackingPath_t &path);
+
+// Exchange two paths without allocating (std::swap on the queues would)
+void            SwapTrackingPath    (TrackingPath_t &a, TrackingPath_t &b);
+
+// MPC reference poses every step meters ahead on the curve
+void            FillHorizon         (const TrackingPath_t &path, TrackingPose_t target_pose, float step, TrackingPose_t horizon[]);
+
+// Largest curvature (1/m) of the curve over distance meters past the current progress,
+// 0 without a curve
+float           CurvatureAhead      (const TrackingPath_t &path, float distance);
+
+// Map-frame velocity to the robot command frame
+TrackingPose_t  GlobalToLocalVel    (TrackingPose_t robot_pose, TrackingPose_t global_vel);
+
+#endif
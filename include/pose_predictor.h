@@ -0,0 +1,43 @@
+#ifndef POSE_PREDICTOR_H
+#define POSE_PREDICTOR_H
+
+#include <vector>
+
+// Map-frame pose at odometry rate: keeps the latest map->odom correction from AMCL
+// and applies the odometry increments received since then
+class PosePredictor
+{
+public:
+    struct Pose_t{
+        float x;
+        float y;
+        float theta;
+    };
+
+    PosePredictor(int history_size = 256);
+
+    void Reset      ();
+    void AddOdom    (double stamp, const Pose_t &odom_pose);
+    void SetMapPose (double stamp, const Pose_t &map_pose);
+
+    // False until both an odometry and a map pose have been received
+    bool Predict    (Pose_t &map_pose) const;
+
+private:
+    struct Stamped_t{
+        double stamp;
+        Pose_t pose;
+    };
+
+    std::vector<Stamped_t> history;
+    int     head;
+    int     count;
+    bool    corrected;
+    Pose_t  correction;
+
+    bool    OdomAt      (double stamp, Pose_t &odom_pose) const;
+    static  Pose_t Compose  (const Pose_t &a, const Pose_t &b);
+    static  Pose_t Inverse  (const Pose_t &a);
+};
+
+#endif
@@ -4,15 +4,24 @@
 #include "stdio.h"
 #include <string.h>
 #include "std_msgs/Int32.h"
+#include "std_msgs/UInt32.h"
 #include "std_msgs/Int16MultiArray.h"
 #include "std_msgs/Float32MultiArray.h"
 #include "geometry_msgs/Pose2D.h"
 #include "geometry_msgs/Twist.h"
 #include <iostream>
+#include <mutex>
 
 #include "main_controller/ControllerData.h"
+#include "main_controller/CommandLinkStats.h"
+#include "main_controller/LatencyHistogram.h"
 #include <nav_msgs/Odometry.h>
 #include <tf/transform_broadcaster.h>
+#include <tf2_ros/transform_broadcaster.h>
+#include <geometry_msgs/TransformStamped.h>
+#include "throttled_publisher.h"
+#include "command_link.h"
+#include "latency_histogram.h"
 
 class Comhardware
 {
@@ -43,10 +52,20 @@ private:
     std::string     sLocal[5];
 
     ros::NodeHandle     Nh;
-    ros::Publisher      OdomPub;
-    ros::Publisher      VelPub;
+    ThrottledPublisher<nav_msgs::Odometry>      OdomPub;
+    ThrottledPublisher<geometry_msgs::Twist>    VelPub;
     ros::Subscriber     SpeedSub;
+    ros::Subscriber     HeartbeatSub;
+    ros::Publisher      LinkStatsPub;
+    ros::Timer          LinkStatsTimer;
+    ros::Publisher      LatencyPub;
+    ros::Timer          LatencyTimer;
     nav_msgs::Odometry  Odom;
+
+    // odom to base_link From the Same Sample, Replaces tf_broadcaster_node
+    bool                                publish_tf;
+    tf2_ros::TransformBroadcaster       OdomTfBroadcaster;
+    geometry_msgs::TransformStamped     OdomTf;
     
     ros::Rate   RosRate;
     ros::Time   CurrentTime;
@@ -57,9 +76,44 @@ private:
     geometry_msgs::Twist      RobotVel;
     
     main_controller::ControllerData     MsgSpeed;
+    main_controller::CommandLinkStats   MsgLinkStats;
+
+    // Transmit and Receive Timers Run on Different Spinner Threads
+    std::mutex              LinkMutex;
+    CommandLink             Link;
+    CommandLink::Command_t  Command;
+
+    // Deadman, the Command Is Only Held While Commands or Matching Heartbeats Keep Arriving
+    double              command_timeout;
+    ros::Time           last_command_time;
+    bool                deadman_stopped = false;
+
+    // Stage Stamps of the Latest Command Until Its First Serial Write
+    typedef enum
+    {
+        STAGE_INPUT      = 0,
+        STAGE_CONTROLLER = 1,
+        STAGE_TRANSPORT  = 2,
+        STAGE_SERIAL     = 3,
+        STAGE_TOTAL      = 4,
+        NUM_STAGES       = 5
+    } Stage_t;
+
+    bool                trace_pending = false;
+    ros::Time           trace_origin;
+    ros::Time           trace_tick;
+    ros::Time           trace_publish;
+    ros::Time           trace_receive;
+    uint32_t            last_command_seq = 0;
+    uint64_t            seq_gaps = 0;
+    LatencyHistogram    StageLatency[NUM_STAGES];
+    main_controller::LatencyHistogram   MsgLatency;
     ros::MultiThreadedSpinner           Mts;
 
     void SerialTransmitEvent(const ros::TimerEvent &event);
     void SerialReceiveEvent(const ros::TimerEvent &event);
     void SpeedSubCallback(const main_controller::ControllerData &msg);
+    void LinkStatsEvent(const ros::TimerEvent &event);
+    void LatencyEvent(const ros::TimerEvent &event);
+    void HeartbeatCallback(const std_msgs::UInt32 &msg);
 };
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef ROLLING_BIT_GRID_H
+#define ROLLING_BIT_GRID_H
+
+#include <stdint.h>
+#include <vector>
+
+// Robot-centred occupancy window in the odom frame, one bit per cell. Moving the robot scrolls
+// the window by shifting rows and words instead of rebuilding it. Scans clear the cells their
+// beams pass through and mark the cells they end in. Footprint queries test a precomputed
+// circle mask row by row with word masks, a fixed cost independent of the window size.
+class RollingBitGrid
+{
+public:
+    struct Pose_t{
+        float x;
+        float y;
+        float theta;
+    };
+
+    static const float NO_OCCUPIED;
+
+    RollingBitGrid();
+
+    // size in meters per side, resolution in meters per cell, footprint radius in meters
+    void    Configure       (float size, float resolution, float footprint_radius);
+    void    Clear           ();
+
+    // Keep the window centred on (x, y), keeping cells that stay inside
+    void    Scroll          (float x, float y);
+
+    // Ray-mark a scan taken from laser_pose (odom frame), beams without a return clear up to range_max
+    void    InsertScan      (const Pose_t &laser_pose, float angle_min, float angle_increment,
+                             const float* ranges, int count, float range_min, float range_max);
+
+    // Take the window position and cells of a grid with the same configuration, no allocation
+    // once sized, so a grid updated elsewhere can be published under a lock
+    void    CopyFrom        (const RollingBitGrid &other);
+
+    bool    Occupied        (float x, float y) const;
+
+    // True when no occupied cell lies under the footprint centred at (x, y); outside the window counts as free
+    bool    FootprintFree   (float x, float y) const;
+
+    // As above, ignoring occupied cells that are also under the footprint centred at (from_x, from_y)
+    bool    FootprintFree   (float x, float y, float from_x, float from_y) const;
+
+    // Distance from (x, y) to the nearest occupied cell centre under the footprint, NO_OCCUPIED if none
+    float   FootprintClearance(float x, float y) const;
+
+    int     Width           () const;
+    int     Height          () const;
+    float   Resolution      () const;
+
+private:
+    float   resolution;
+    int     width;              // Cells per row
+    int     height;             // Rows
+    int     words;              // 64-bit words per row
+    int     origin_x;           // World cell index of column 0
+    int     origin_y;           // World cell index of row 0
+    std::vector<uint64_t> cells;
+
+    // Footprint Mask, Half Width in Cells per Row Offset
+    int                 footprint_rows;
+    std::vector<int>    footprint_half;
+
+    // Beam Tables and Per-Step Scratch for Ray Marking
+    float               table_angle_min;
+    float               table_increment;
+    std::vector<float>  beam_cos;
+    std::vector<float>  beam_sin;
+    std::vector<float>  ray_x;
+    std::vector<float>  ray_y;
+    std::vector<float>  beam_steps;
+    std::vector<int>    step_cell;
+
+    int     CellIndex       (float v) const;
+    void    SetBit          (int cx, int cy, bool value);
+    bool    GetBit          (int cx, int cy) const;
+    bool    RowSpanOccupied (int row, int first, int last) const;
+    void    ShiftRows       (int dy);
+    void    ShiftColumns    (int dx);
+};
+
+#endif
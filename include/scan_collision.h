@@ -0,0 +1,59 @@
+#ifndef SCAN_COLLISION_H
+#define SCAN_COLLISION_H
+
+#include <vector>
+
+// Forward-simulates a holonomic velocity against the latest laser scan. The footprint is a
+// circle, so rotation does not change clearance and only the translation is checked.
+// Beam directions are tabulated once per scan geometry; the time-to-collision kernel runs over
+// structure-of-arrays points and is written to be vectorised (omp simd).
+class ScanCollisionChecker
+{
+public:
+    struct Config_t{
+        float laser_x;          // Laser position in base_link (m)
+        float laser_y;
+        float laser_yaw;        // Laser orientation in base_link (rad)
+        float robot_radius;     // Footprint radius including margin (m)
+        float self_radius;      // Returns closer than this to the base centre are the robot itself (m)
+        float stop_time;        // Stop when contact is closer than this (s)
+        float slow_time;        // Full speed when contact is further than this (s)
+    };
+
+    ScanCollisionChecker();
+
+    void    Configure       (const Config_t &config);
+
+    // Convert a scan to base_link points, ranges outside [range_min, range_max] are dropped
+    void    Update          (float angle_min, float angle_increment, const float* ranges, int count,
+                             float range_min, float range_max);
+
+    bool    Empty           () const;
+
+    // Seconds until the footprint touches a scan point moving at (vx, vy) m/s in base_link,
+    // a large value when nothing is hit
+    float   TimeToCollision (float vx, float vy) const;
+
+    // Factor in [0, 1] to apply to the velocity so the robot slows down and stops before contact
+    float   SpeedScale      (float vx, float vy, float &time_to_collision) const;
+
+    static const float NO_COLLISION;
+
+private:
+    Config_t            Config;
+
+    // Beam Direction Tables for the Current Scan Geometry
+    float               table_angle_min;
+    float               table_increment;
+    std::vector<float>  beam_cos;
+    std::vector<float>  beam_sin;
+
+    // Scan Points in base_link, Invalid Beams Parked Far Away
+    std::vector<float>  point_x;
+    std::vector<float>  point_y;
+    int                 valid_count;
+
+    void    BuildTables     (float angle_min, float angle_increment, int count);
+};
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef SPEED_GOVERNOR_H
+#define SPEED_GOVERNOR_H
+
+// Allowed translation speed for the current tick. Each condition maps linearly between a
+// tight and a relaxed threshold onto [min_speed, max_speed] and the lowest one wins: clearance
+// ahead of the robot, curvature of the path ahead (lateral acceleration limit) and the AMCL
+// position uncertainty.
+class SpeedGovernor
+{
+public:
+    struct Config_t{
+        float min_speed;            // Lowest limit the governor hands out (cm/s)
+        float max_speed;            // Limit with open space, straight path and good localization (cm/s)
+        float slow_clearance;       // Clearance at or below which min_speed applies (m)
+        float free_clearance;       // Clearance at or above which max_speed applies (m)
+        float max_lateral_accel;    // Curvature limit v^2 * k <= max_lateral_accel (m/s^2)
+        float curvature_lookahead;  // Path length ahead searched for the sharpest turn (m)
+        float good_position_std;    // Position std at or below which max_speed applies (m)
+        float bad_position_std;     // Position std at or above which min_speed applies (m)
+    };
+
+    SpeedGovernor();
+
+    void    Configure       (const Config_t &config);
+    const Config_t& Config  () const;
+
+    // clearance in m, curvature in 1/m, position_std in m; returns the limit in cm/s
+    float   Limit           (float clearance, float curvature, float position_std) const;
+
+private:
+    Config_t    Settings;
+
+    float   Ramp            (float value, float tight, float relaxed) const;
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef THROTTLED_PUBLISHER_H
+#define THROTTLED_PUBLISHER_H
+
+#include <ros/ros.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <string.h>
+
+// Publisher that only sends a message when its content changed, at most max_rate times per second,
+// and resends the last state every refresh_period so late subscribers still receive it. A changed
+// message held back by the rate limit is reported by Held() until a later one goes out, so an
+// event-driven caller knows to publish again instead of waiting for the refresh.
+template <class M>
+class ThrottledPublisher
+{
+public:
+    ThrottledPublisher(): MinInterval(0.0), RefreshPeriod(1.0), Sent(false), Holding(false) {}
+
+    void Advertise(ros::NodeHandle &nh, const std::string &topic, uint32_t queue_size, double max_rate, double refresh_period)
+    {
+        Pub           = nh.advertise<M>(topic, queue_size);
+        MinInterval   = (max_rate > 0.0) ? 1.0 / max_rate : 0.0;
+        RefreshPeriod = refresh_period;
+        Sent          = false;
+        Holding       = false;
+    }
+
+    // Returns true if the message went out
+    bool Publish(const M &msg)
+    {
+        return Publish(msg, 0);
+    }
+
+    // Same, with the first ignore_prefix serialized bytes (trace stamps) left out of the comparison
+    bool Publish(const M &msg, uint32_t ignore_prefix)
+    {
+        ros::Time now = ros::Time::now();
+        double elapsed = Sent ? (now - LastSent).toSec() : 1e9;
+
+        // Compare Serialized Bytes Against the Last Message Sent
+        uint32_t length = ros::serialization::serializationLength(msg);
+        Buffer.resize(length);
+        ros::serialization::OStream stream(Buffer.data(), length);
+        ros::serialization::serialize(stream, msg);
+
+        ignore_prefix = std::min(ignore_prefix, length);
+        bool changed = !Sent || Buffer.size() != Last.size() ||
+                       memcmp(Buffer.data() + ignore_prefix, Last.data() + ignore_prefix, length - ignore_prefix) != 0;
+        if(elapsed < MinInterval)
+        {
+            Holding = changed;
+            return false;
+        }
+        if(!changed && elapsed < RefreshPeriod)
+        {
+            Holding = false;
+            return false;
+        }
+
+        Pub.publish(msg);
+        Last.swap(Buffer);
+        LastSent = now;
+        Sent = true;
+        Holding = false;
+        return true;
+    }
+
+    // The last message offered changed but was dropped by the rate limit
+    bool Held() const
+    {
+        return Holding;
+    }
+
+    // Send the next message regardless of content or rate
+    void Force()
+    {
+        Sent = false;
+    }
+
+private:
+    ros::Publisher          Pub;
+    ros::Time               LastSent;
+    std::vector<uint8_t>    Last;
+    std::vector<uint8_t>    Buffer;
+    double                  MinInterval;
+    double                  RefreshPeriod;
+    bool                    Sent;
+    bool                    Holding;
+};
+
+#endif
@@ -0,0 +1,246 @@
+#include "command_link.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+static const uint8_t SYNC_0         = 0xA5;
+static const uint8_t SYNC_1         = 0x5A;
+static const uint8_t VERSION        = 1;
+static const uint8_t TYPE_COMMAND   = 0x01;
+static const uint8_t TYPE_ACK       = 0x81;
+static const int     HEADER_LENGTH  = 5;
+static const int     CRC_LENGTH     = 2;
+static const int     COMMAND_LENGTH = 17;
+static const int     ACK_LENGTH     = 4;
+
+static void PutU16(uint8_t* p, uint16_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static uint16_t GetU16(const uint8_t* p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+// Round to the Fixed-Point Step and Saturate to int16
+static int16_t ToFixed(float value, float step)
+{
+    float scaled = roundf(value / step);
+    scaled = std::min(std::max(scaled, -32768.0f), 32767.0f);
+    return (int16_t)scaled;
+}
+
+CommandLink::CommandLink(): protocol(LEGACY), seq(0), carry_length(0), stats(), rtt_sum(0.0)
+{
+    for(int i = 0; i < HISTORY; i++)
+    {
+        pending[i] = false;
+    }
+}
+
+void CommandLink::SetProtocol(Protocol_t protocol)
+{
+    this->protocol = protocol;
+}
+
+CommandLink::Protocol_t CommandLink::Protocol() const
+{
+    return protocol;
+}
+
+bool CommandLink::ParseProtocol(const std::string &name, Protocol_t &protocol)
+{
+    if(name == "legacy")
+    {
+        protocol = LEGACY;
+        return true;
+    }
+    if(name == "v1")
+    {
+        protocol = V1;
+        return true;
+    }
+    return false;
+}
+
+const char* CommandLink::ProtocolName(Protocol_t protocol)
+{
+    return (protocol == V1) ? "v1" : "legacy";
+}
+
+uint16_t CommandLink::Crc16(const uint8_t* data, int length)
+{
+    uint16_t crc = 0xFFFF;
+    for(int i = 0; i < length; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+        for(int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+int CommandLink::Encode(const Command_t &command, double now, uint8_t frame[MAX_FRAME])
+{
+    if(protocol == LEGACY)
+    {
+        int16_t speed[3];
+        for(int i = 0; i < 3; i++)
+        {
+            speed[i] = command.velocity[i];
+        }
+        frame[0] = 'm';
+        frame[1] = 'r';
+        frame[2] = 'i';
+        memcpy(frame + 3, &speed[0], 2);
+        memcpy(frame + 5, &speed[1], 2);
+        memcpy(frame + 7, &speed[2], 2);
+        frame[9] = command.lamp;
+        frame[10] = command.status;
+        stats.sent++;
+        return 11;
+    }
+
+    seq++;
+
+    frame[0] = SYNC_0;
+    frame[1] = SYNC_1;
+    frame[2] = VERSION;
+    frame[3] = TYPE_COMMAND;
+    frame[4] = COMMAND_LENGTH;
+
+    uint8_t* payload = frame + HEADER_LENGTH;
+    PutU16(payload, seq);
+    for(int i = 0; i < 3; i++)
+    {
+        PutU16(payload + 2 + 2 * i, ToFixed(command.velocity[i], 0.1));
+        PutU16(payload + 8 + 2 * i, command.has_accel ? ToFixed(command.accel[i], 1.0) : 0);
+    }
+    payload[14] = command.lamp;
+    payload[15] = command.status;
+    payload[16] = command.has_accel ? 0x01 : 0x00;
+
+    PutU16(payload + COMMAND_LENGTH, Crc16(frame + 2, HEADER_LENGTH - 2 + COMMAND_LENGTH));
+
+    // A Slot Still Waiting for Its Ack Is Overwritten, That Command Was Lost
+    int slot = seq % HISTORY;
+    if(pending[slot])
+    {
+        stats.lost++;
+    }
+    sent_seq[slot] = seq;
+    sent_time[slot] = now;
+    pending[slot] = true;
+    stats.sent++;
+
+    return HEADER_LENGTH + COMMAND_LENGTH + CRC_LENGTH;
+}
+
+void CommandLink::HandleAck(const uint8_t* payload, double now)
+{
+    uint16_t ack_seq = GetU16(payload);
+    int slot = ack_seq % HISTORY;
+
+    stats.firmware_missed += payload[3] + (payload[2] & 0x01);
+
+    // Late or Duplicate Acks Only Count Once
+    if(!pending[slot] || sent_seq[slot] != ack_seq)
+    {
+        return;
+    }
+    pending[slot] = false;
+
+    double rtt = now - sent_time[slot];
+    stats.acked++;
+    stats.rtt_last = rtt;
+    stats.rtt_max = std::max(stats.rtt_max, rtt);
+    rtt_sum += rtt;
+    stats.rtt_mean = rtt_sum / stats.acked;
+}
+
+int CommandLink::Extract(uint8_t* buf, int length, int capacity, double now)
+{
+    length = std::min(length, (int)MAX_RECEIVE);
+
+    // Held Back Partial Frame First, Then the New Bytes
+    memcpy(stream, carry, carry_length);
+    memcpy(stream + carry_length, buf, length);
+    int total = carry_length + length;
+    carry_length = 0;
+
+    int out = 0;
+    int i = 0;
+    while(i < total)
+    {
+        if(stream[i] != SYNC_0 || (i + 1 < total && stream[i + 1] != SYNC_1))
+        {
+            if(out < capacity)
+            {
+                buf[out++] = stream[i];
+            }
+            i++;
+            continue;
+        }
+
+        // Wait for the Header, Then for the Whole Frame
+        int left = total - i;
+        if(left < HEADER_LENGTH)
+        {
+            memcpy(carry, stream + i, left);
+            carry_length = left;
+            break;
+        }
+
+        int payload_length = stream[i + 4];
+        int frame_length = HEADER_LENGTH + payload_length + CRC_LENGTH;
+        if(frame_length > MAX_FRAME)
+        {
+            stats.rejected++;
+            i++;
+            continue;
+        }
+        if(left < frame_length)
+        {
+            memcpy(carry, stream + i, left);
+            carry_length = left;
+            break;
+        }
+
+        // A Bad CRC Skips Only the Sync Byte so a Real Frame Inside Is Still Found
+        const uint8_t* frame = stream + i;
+        uint16_t crc = GetU16(frame + HEADER_LENGTH + payload_length);
+        if(crc != Crc16(frame + 2, HEADER_LENGTH - 2 + payload_length))
+        {
+            stats.rejected++;
+            i++;
+            continue;
+        }
+
+        if(frame[2] == VERSION && frame[3] == TYPE_ACK && payload_length >= ACK_LENGTH)
+        {
+            HandleAck(frame + HEADER_LENGTH, now);
+        }
+        else
+        {
+            stats.rejected++;
+        }
+        i += frame_length;
+    }
+    return out;
+}
+
+CommandLink::Stats_t CommandLink::GetStats(bool reset)
+{
+    Stats_t current = stats;
+    if(reset)
+    {
+        stats = Stats_t();
+        rtt_sum = 0.0;
+    }
+    return current;
+}
@@ -0,0 +1,446 @@
+#include "control_core.h"
+
+#include <algorithm>
+#include <cmath>
+
+#define MATH_PI 3.1415926535897932384626433832795
+
+ControlCore::ControlCore()
+{
+    StatusControl = 0;
+    GuidedMode = 0;
+    rumble_status = false;
+    prev_crashed = false;
+    was_tracking = false;
+    switch_pending = false;
+    clock = 0.0;
+    rumble_start = 0.0;
+    control_dt = 0.0;
+    pace_scale = 1.0;
+
+    for(int i = 0; i < NUM_BUTTONS; i++)
+    {
+        prev_button[i] = 0;
+    }
+
+    Output = Output_t();
+
+    Configure(DefaultConfig());
+}
+
+ControlCore::Config_t ControlCore::DefaultConfig()
+{
+    Config_t config;
+    config.use_path_spline      = true;
+    config.lookahead            = 0.1;
+    config.mpc_reference_speed  = 0.25;
+    config.max_speed            = 30;
+    config.use_speed_governor   = true;
+    config.governor             = SpeedGovernor().Config();
+    config.use_wheel_limit      = false;        // Placeholder geometry below, set the real one first
+    config.kinematics           = OmniKinematics().Config();
+    config.rumble_duration      = 0.57;
+    config.scan_guard_manual    = false;
+    config.grid_check_time      = 0.5;
+    config.footprint_radius     = 0.3;
+    config.controllers          = DefaultPathControllerConfig();
+    return config;
+}
+
+void ControlCore::Configure(const Config_t &config)
+{
+    Config = config;
+    Governor.Configure(Config.governor);
+    Kinematics.Configure(Config.kinematics);
+    MakePathController(PathControllerName(Tracker), Config.controllers, Tracker);
+}
+
+bool ControlCore::RequestController(const std::string &name)
+{
+    if(!MakePathController(name, Config.controllers, Requested))
+    {
+        return false;
+    }
+
+    // Never Swap Controllers in the Middle of a Run
+    if(Tracking())
+    {
+        switch_pending = true;
+    }
+    else
+    {
+        std::swap(Tracker, Requested);
+        switch_pending = false;
+    }
+    return true;
+}
+
+const char* ControlCore::ControllerName() const
+{
+    return PathControllerName(Tracker);
+}
+
+bool ControlCore::Tracking() const
+{
+    return GuidedMode && StatusControl && path.x.size() > 0;
+}
+
+bool ControlCore::Released(const Input_t &input, DS4_Button button) const
+{
+    return input.buttons[button] == 0 && prev_button[button] == 1;
+}
+
+bool ControlCore::Pressed(const Input_t &input, DS4_Button button) const
+{
+    return input.buttons[button] == 1 && prev_button[button] == 0;
+}
+
+void ControlCore::StartRumble()
+{
+    rumble_status = true;
+    Output.rumble = 0.5;
+    rumble_start = clock;
+}
+
+const ControlCore::Output_t& ControlCore::Step(const Input_t &input, float dt)
+{
+    float robot_vel[3] = {0, 0, 0};
+
+    clock += dt;
+    control_dt += dt;
+
+    Output.go_home = false;
+    Output.reset_odom = false;
+    Output.path_finished = false;
+    Output.controller_switched = false;
+
+    // Adopt New Path, the Previous One Goes Back to the Caller
+    if(input.path)
+    {
+        SwapTrackingPath(path, *input.path);
+    }
+
+    // Set Status Control using TRIANGLE Button
+    if(Released(input, TRIANGLE))
+    {
+        StatusControl ^= 1;
+    }
+
+    // Clear Path Generated using CIRCLE Button
+    if(Released(input, CIRCLE))
+    {
+        ClearTrackingPath(path);
+    }
+
+    // Set GUIDED/MANUAL Mode Using OPTIONS Button
+    if(Released(input, OPTIONS))
+    {
+        GuidedMode ^= 1;
+        StartRumble();
+    }
+
+    // Reset local Odom
+    if(Released(input, SQUARE))
+    {
+        Output.reset_odom = true;
+    }
+
+    // Set RTH Mode Using SHARE Button
+    if(Pressed(input, SHARE))
+    {
+        // Clear Current Path and Ask for a Path to the Origin
+        ClearTrackingPath(path);
+        Output.go_home = true;
+        StartRumble();
+    }
+
+    for(int i = 0; i < NUM_BUTTONS; i++)
+    {
+        prev_button[i] = input.buttons[i];
+    }
+
+    // Rumble Feedback Event
+    if(rumble_status && clock - rumble_start >= Config.rumble_duration)
+    {
+        Output.rumble = 0.0;
+        rumble_status = false;
+    }
+
+    prev_crashed = input.crashed;
+
+    // Switch Controller Only While Not Tracking, Start Each Run with Fresh Controller State
+    bool tracking = Tracking();
+    if(!tracking)
+    {
+        if(switch_pending)
+        {
+            std::swap(Tracker, Requested);
+            switch_pending = false;
+            Output.controller_switched = true;
+        }
+    }
+    else if(!was_tracking)
+    {
+        ResetPathController(Tracker);
+        control_dt = 0.0;
+        pace_scale = 1.0;
+    }
+    was_tracking = tracking;
+
+    // Go to Autonomous Mode
+    if(GuidedMode)
+    {
+        // Go to AUTONOMOUS Mode with Indicator
+        if(StatusControl)
+        {
+            // Set YELLOW Indicator for GUIDED Mode
+            Output.led[0] = 0.3;
+            Output.led[1] = 0.3;
+            Output.led[2] = 0.0;
+
+            // Search for Closest Node using Pure Pursuit, Nothing to Do Without a Path
+            if(path.x.size() > 0)
+            {
+                TrackingPose_t next_pose = PurePursuit(input.pose, input.obstacle);
+                Output.target = next_pose;
+
+                // Path Tracking Controller
+                TrackingInput.robot = input.pose;
+                TrackingInput.target = next_pose;
+                TrackingInput.dt = control_dt;
+                TrackingInput.max_speed = 0.0;
+                control_dt = 0.0;
+
+                // Governed Translation Limit Towards the Target Bounds the Controller, Not Only Its Output.
+                // The Controllers Follow a Target lookahead Ahead, Above max_speed Both Paces Stretch With the
+                // Limit, Next Tick for the Lookahead as the Target Is Already Taken
+                float reference_speed = Config.mpc_reference_speed;
+                if(Config.use_speed_governor)
+                {
+                    TrackingPose_t heading = {next_pose.x - input.pose.x, next_pose.y - input.pose.y, 0.0};
+                    TrackingPose_t local_heading = GlobalToLocalVel(input.pose, heading);
+                    float direction[3] = {local_heading.x, local_heading.y, 0.0};
+                    TrackingInput.max_speed = SpeedLimit(input, direction);
+                    pace_scale = std::max(TrackingInput.max_speed / Config.max_speed, 1.0f);
+                    reference_speed = std::min(reference_speed * pace_scale, TrackingInput.max_speed / 100.0f);
+                }
+
+                // MPC Needs the Upcoming Stretch of Path, Paced No Faster than the Governor Allows
+                if(std::holds_alternative<MpcTracker>(Tracker))
+                {
+                    FillHorizon(path, next_pose, reference_speed * Config.controllers.mpc.dt, TrackingInput.horizon);
+                }
+
+                TrackingPose_t pure_pursuit_vel = ComputePathController(Tracker, TrackingInput);
+
+                // Convert Pure Pursuit Velocity to Local Velocity
+                TrackingPose_t local_vel = GlobalToLocalVel(input.pose, pure_pursuit_vel);
+                robot_vel[0] = local_vel.x;
+                robot_vel[1] = local_vel.y;
+                robot_vel[2] = local_vel.theta;
+
+                Output.local_desired_vel.x = local_vel.x * cos(MATH_PI/2) + local_vel.y * sin(MATH_PI/2);
+                Output.local_desired_vel.y = -1 * local_vel.x * sin(MATH_PI/2) + local_vel.y * cos(MATH_PI/2);
+                Output.local_desired_vel.theta = local_vel.theta;
+
+                // Obstacle Avoidance Control with WHITE Indicator
+                if(input.obstacle)
+                {
+                    Output.led[0] = 1.0;
+                    Output.led[1] = 1.0;
+                    Output.led[2] = 1.0;
+
+                    robot_vel[0] = input.obstacle_vel.x * cos(MATH_PI/2) - input.obstacle_vel.y * sin(MATH_PI/2);
+                    robot_vel[1] = input.obstacle_vel.x * sin(MATH_PI/2) + input.obstacle_vel.y * cos(MATH_PI/2);
+                    robot_vel[2] = input.obstacle_vel.theta;
+                }
+            }
+        }
+
+        // Pause AUTONOMOUS Mode with RED Indicator
+        else
+        {
+            Output.led[0] = 1.0;
+            Output.led[1] = 0.0;
+            Output.led[2] = 0.13;
+
+            Output.local_desired_vel.x = 0.0;
+            Output.local_desired_vel.y = 0.0;
+            Output.local_desired_vel.theta = 0.0;
+        }
+    }
+
+    // Go to Manual Control Mode
+    else
+    {
+        // Go to Manual Control RUN Mode with GREEN Indicator
+        if(StatusControl)
+        {
+            Output.led[0] = 0.12;
+            Output.led[1] = 0.75;
+            Output.led[2] = 0.13;
+
+            // Set Robot Speed from Joy Axis
+            robot_vel[0] = -1 * input.axes[0] * 45;
+            robot_vel[1] = input.axes[1] * 45;
+            robot_vel[2] = input.axes[2] * 20;
+        }
+
+        // Go to Manual Control LOCK Mode with RED Indicator
+        else
+        {
+            Output.led[0] = 1.0;
+            Output.led[1] = 0.0;
+            Output.led[2] = 0.13;
+        }
+    }
+
+    // Limit Robot Speed, Translation by the Governor When Enabled, Joystick Never Above max_speed
+    int linear_limit = Config.max_speed;
+    if(Config.use_speed_governor)
+    {
+        int governed = SpeedLimit(input, robot_vel);
+        linear_limit = GuidedMode ? governed : std::min(governed, Config.max_speed);
+    }
+    Output.speed_limit = linear_limit;
+
+    // Shorten the Translation Without Turning It, Rotation Has Its Own Limit
+    float speed = sqrt(robot_vel[0] * robot_vel[0] + robot_vel[1] * robot_vel[1]);
+    if(speed > linear_limit)
+    {
+        robot_vel[0] *= linear_limit / speed;
+        robot_vel[1] *= linear_limit / speed;
+    }
+    robot_vel[2] = std::min(std::max(robot_vel[2], (float)-Config.max_speed), (float)Config.max_speed);
+
+    // One Factor for the Whole Command When a Wheel Would Saturate, Heading and Turn Ratio Kept
+    Output.wheel_scale = 1.0;
+    if(Config.use_wheel_limit)
+    {
+        Output.wheel_scale = Kinematics.Saturate(robot_vel);
+    }
+
+    // Slow Down or Stop Before the Commanded Translation Reaches the Latest Scan
+    Output.collision_scale = 1.0;
+    Output.time_to_collision = ScanCollisionChecker::NO_COLLISION;
+    if(input.scan && StatusControl && (GuidedMode || Config.scan_guard_manual))
+    {
+        float scale = input.scan->SpeedScale(robot_vel[1] / 100.0, -robot_vel[0] / 100.0, Output.time_to_collision);
+        robot_vel[0] *= scale;
+        robot_vel[1] *= scale;
+        Output.collision_scale = scale;
+    }
+
+    // Stop When the Footprint Along the Commanded Translation Meets a Remembered Obstacle
+    Output.grid_blocked = false;
+    if(input.grid && StatusControl && (GuidedMode || Config.scan_guard_manual) && !GridPathFree(input, robot_vel))
+    {
+        robot_vel[0] = 0;
+        robot_vel[1] = 0;
+        Output.grid_blocked = true;
+    }
+
+    // Integer Command Truncates as Before, the Fine Command Keeps the Fraction for Fixed-Point Links
+    for(int i = 0; i <= 2; i++)
+    {
+        Output.accel[i] = (dt > 0.0) ? (robot_vel[i] - Output.velocity[i]) / dt : 0.0;
+        Output.velocity[i] = robot_vel[i];
+        Output.command[i] = robot_vel[i];
+    }
+    Output.status_control = StatusControl;
+
+    // Keep Ticking While Tracking a Path or Timing the Rumble, Otherwise Wait for Inputs
+    Output.keep_ticking = rumble_status || Tracking();
+    return Output;
+}
+
+TrackingPose_t ControlCore::PurePursuit(TrackingPose_t robot_pose, bool obstacle)
+{
+    TrackingPose_t target_pose;
+    bool finished = false;
+
+    if(Config.use_path_spline && !path.curve.Empty())
+    {
+        target_pose = PurePursuitSpline(robot_pose, path, Config.lookahead * pace_scale, obstacle, finished);
+    }
+    else
+    {
+        target_pose = ::PurePursuit(robot_pose, path, Config.lookahead * pace_scale, obstacle, finished);
+    }
+
+    if(finished)
+    {
+        Output.path_finished = true;
+        StartRumble();
+    }
+    return target_pose;
+}
+
+bool ControlCore::GridPathFree(const Input_t &input, const float robot_vel[3]) const
+{
+    // Command Frame to Odom Frame, Forward is vel[1] and Left is -vel[0] (cm/s)
+    float forward = robot_vel[1] / 100.0;
+    float left = -robot_vel[0] / 100.0;
+    float c = cos(input.odom_pose.theta);
+    float s = sin(input.odom_pose.theta);
+    float vx = forward * c - left * s;
+    float vy = forward * s + left * c;
+
+    // Cells the Footprint Already Overlaps Only Block Moving Closer to Them, so the Robot Can Back Out
+    float x0 = input.odom_pose.x;
+    float y0 = input.odom_pose.y;
+    float clearance = input.grid->FootprintClearance(x0, y0);
+
+    // A Fixed Number of Footprint Samples Keeps the Check Constant Time
+    static const int SAMPLES = 4;
+    for(int i = 1; i <= SAMPLES; i++)
+    {
+        float t = Config.grid_check_time * i / SAMPLES;
+        float x = x0 + vx * t;
+        float y = y0 + vy * t;
+        if(!input.grid->FootprintFree(x, y, x0, y0))
+        {
+            return false;
+        }
+        if(clearance < RollingBitGrid::NO_OCCUPIED && input.grid->FootprintClearance(x, y) < clearance)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+float ControlCore::SpeedLimit(const Input_t &input, const float robot_vel[3]) const
+{
+    // Clearance Along the Commanded Direction is the Time to Contact at 1 m/s
+    float clearance = ScanCollisionChecker::NO_COLLISION;
+    float forward = robot_vel[1];
+    float left = -robot_vel[0];
+    float speed = sqrt(forward * forward + left * left);
+    if(input.scan && speed > 0.0)
+    {
+        clearance = input.scan->TimeToCollision(forward / speed, left / speed);
+    }
+
+    // Walls of the Stored Map Count in Every Direction, Also Those the Scan Cannot See
+    if(input.clearance_map)
+    {
+        float map_clearance = input.clearance_map->Clearance(input.pose.x, input.pose.y) - Config.footprint_radius;
+        clearance = std::min(clearance, std::max(map_clearance, 0.0f));
+    }
+
+    float curvature = 0.0;
+    if(GuidedMode)
+    {
+        curvature = CurvatureAhead(path, Config.governor.curvature_lookahead);
+    }
+
+    float limit = Governor.Limit(clearance, curvature, input.position_std);
+
+    // Unknown Clearance Never Allows More than the Fixed Limit
+    if(!input.scan)
+    {
+        limit = std::min(limit, (float)Config.max_speed);
+    }
+    return limit;
+}
@@ -0,0 +1,232 @@
+#include "control_executor.h"
+
+#include <chrono>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+static int64_t ToNs(const struct timespec &ts)
+{
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static struct timespec FromNs(int64_t ns)
+{
+    struct timespec ts;
+    ts.tv_sec  = ns / 1000000000LL;
+    ts.tv_nsec = ns % 1000000000LL;
+    return ts;
+}
+
+static int64_t NowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ToNs(ts);
+}
+
+ControlExecutor::ControlExecutor(): Running(false), Pending(false), EventDriven(false), KeepAlive(0.2), PeriodNs(5000000), Policy(SKIP)
+{
+    ResetStats();
+}
+
+ControlExecutor::~ControlExecutor()
+{
+    Stop();
+}
+
+bool ControlExecutor::Start(double rate_hz, Overrun_Policy policy, std::function<bool()> tick, int priority)
+{
+    if(Running || rate_hz <= 0.0)
+    {
+        return false;
+    }
+
+    PeriodNs = (int64_t)(1e9 / rate_hz);
+    Policy   = policy;
+    Tick     = tick;
+    ResetStats();
+
+    Running = true;
+    Worker = std::thread(&ControlExecutor::Loop, this);
+
+    // Optional Real-Time Priority for the Control Thread
+    if(priority > 0)
+    {
+        struct sched_param param;
+        param.sched_priority = priority;
+        if(pthread_setschedparam(Worker.native_handle(), SCHED_FIFO, &param) != 0)
+        {
+            printf("ControlExecutor: cannot set SCHED_FIFO priority %d, running with default scheduling\n", priority);
+        }
+    }
+    return true;
+}
+
+void ControlExecutor::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(WakeMutex);
+        Running = false;
+    }
+    WakeCond.notify_one();
+    if(Worker.joinable())
+    {
+        Worker.join();
+    }
+}
+
+void ControlExecutor::EventMode(bool enable, double keep_alive)
+{
+    EventDriven = enable;
+    KeepAlive   = keep_alive;
+}
+
+void ControlExecutor::Notify()
+{
+    if(!EventDriven)
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(WakeMutex);
+        Pending = true;
+    }
+    WakeCond.notify_one();
+}
+
+ControlExecutor::Stats_t ControlExecutor::GetStats(bool reset)
+{
+    std::lock_guard<std::mutex> lock(StatsMutex);
+
+    Stats_t stats = Stats;
+    if(stats.ticks > 0)
+    {
+        stats.compute_mean = ComputeSum / stats.ticks;
+    }
+    if(PeriodCount > 0)
+    {
+        stats.period_mean = PeriodSum / PeriodCount;
+    }
+    else
+    {
+        stats.period_min = 0.0;
+    }
+
+    if(reset)
+    {
+        ResetStats();
+    }
+    return stats;
+}
+
+void ControlExecutor::Loop()
+{
+    int64_t deadline   = NowNs() + PeriodNs;
+    int64_t prev_start = 0;
+    bool    idle       = false;
+
+    while(Running)
+    {
+        if(idle)
+        {
+            // Park Until an Input Arrives or the Keep-Alive Expires
+            std::unique_lock<std::mutex> lock(WakeMutex);
+            WakeCond.wait_for(lock, std::chrono::duration<double>(KeepAlive), [this]{ return Pending || !Running; });
+            lock.unlock();
+
+            if(!Running)
+            {
+                break;
+            }
+
+            deadline   = NowNs();
+            prev_start = 0;
+        }
+        else
+        {
+            // Sleep Until Absolute Deadline, Immune to Tick Duration Drift
+            struct timespec ts = FromNs(deadline);
+            while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0 && Running){}
+        }
+
+        // Inputs Arriving During the Tick Request Another One
+        Pending = false;
+
+        int64_t start  = NowNs();
+        bool    active = Tick();
+        int64_t end    = NowNs();
+
+        bool woken = idle;
+        idle = EventDriven && !active;
+
+        int64_t scheduled = deadline;
+        int64_t skipped = 0;
+        bool missed = false;
+
+        deadline += PeriodNs;
+        if(end > deadline)
+        {
+            missed = true;
+            int64_t behind = (end - deadline) / PeriodNs + 1;
+
+            // Drop Missed Periods, or Catch Up Within a Bounded Backlog
+            if(Policy == SKIP || behind > MAX_CATCH_UP)
+            {
+                deadline += behind * PeriodNs;
+                skipped = behind;
+            }
+        }
+
+        // Accumulate Timing Statistics
+        std::lock_guard<std::mutex> lock(StatsMutex);
+        double compute = (end - start) * 1e-3;
+        double jitter  = (start - scheduled) * 1e-3;
+
+        Stats.ticks++;
+        Stats.idle_wakeups += woken;
+        Stats.missed  += missed;
+        Stats.skipped += skipped;
+        ComputeSum    += compute;
+        if(compute > Stats.compute_max)
+        {
+            Stats.compute_max = compute;
+        }
+        if(jitter > Stats.jitter_max)
+        {
+            Stats.jitter_max = jitter;
+        }
+        if(prev_start != 0)
+        {
+            double period = (start - prev_start) * 1e-3;
+            PeriodSum += period;
+            PeriodCount++;
+            if(period < Stats.period_min)
+            {
+                Stats.period_min = period;
+            }
+            if(period > Stats.period_max)
+            {
+                Stats.period_max = period;
+            }
+        }
+        prev_start = idle ? 0 : start;
+    }
+}
+
+void ControlExecutor::ResetStats()
+{
+    Stats.ticks        = 0;
+    Stats.missed       = 0;
+    Stats.skipped      = 0;
+    Stats.idle_wakeups = 0;
+    Stats.period_mean  = 0.0;
+    Stats.period_min   = 1e12;
+    Stats.period_max   = 0.0;
+    Stats.compute_mean = 0.0;
+    Stats.compute_max  = 0.0;
+    Stats.jitter_max   = 0.0;
+    PeriodSum   = 0.0;
+    PeriodCount = 0;
+    ComputeSum  = 0.0;
+}
@@ -1,7 +1,7 @@
 #include <ros/ros.h>
 #include "control_layout.h"
 
-Robot::Robot(): RosRate(200)
+Robot::Robot()
 {
     // Initialize
     ROS_INFO("Robot Main Controller");
@@ -16,17 +16,206 @@ Robot::Robot(): RosRate(200)
     Sub_Crashed           = Nh.subscribe("/crashed", 1, &Robot::Crashed_Status_Callback, this);
     Sub_Obstacle          = Nh.subscribe("/obstacle_detected", 1, &Robot::Obstacle_Status_Callback, this);
     Sub_Obs_Vel           = Nh.subscribe("/velocity_obstacle/opt_vel", 10, &Robot::Obstacle_Vel_Callback, this);
+    Sub_Set_Controller    = Nh.subscribe("/main_controller/set_controller", 1, &Robot::Set_Controller_Callback, this);
+    Sub_Scan              = Nh.subscribe("/scan", 1, &Robot::Scan_Callback, this);
 
-    Pub_Vel               = Nh.advertise<main_controller::ControllerData>("robot/cmd_vel", 10);
-    Pub_Joy_Feedback      = Nh.advertise<sensor_msgs::JoyFeedbackArray>("/set_feedback", 10);
     Pub_Origin            = Nh.advertise<geometry_msgs::PoseStamped>("/goal", 1);
-    Pub_Pure_Pursuit      = Nh.advertise<geometry_msgs::PoseStamped>("/pure_pursuit_pose", 10);
-    Pub_Local_Desired_Vel = Nh.advertise<geometry_msgs::Twist>("/main_controller/local_desired_vel", 10);
+    Pub_Loop_Stats        = Nh.advertise<main_controller::LoopStats>("/main_controller/loop_stats", 10);
+
+    // Parameters
+    ros::NodeHandle Nh_Private("~");
+
+    // Periodic Outputs Only Go Out on Change, Rate Capped, with a Periodic Refresh
+    double vel_max_rate, feedback_max_rate, pure_pursuit_max_rate, local_vel_max_rate, refresh_period;
+    Nh_Private.param("vel_max_rate", vel_max_rate, 200.0);
+    Nh_Private.param("feedback_max_rate", feedback_max_rate, 20.0);
+    Nh_Private.param("pure_pursuit_max_rate", pure_pursuit_max_rate, 20.0);
+    Nh_Private.param("local_vel_max_rate", local_vel_max_rate, 50.0);
+    Nh_Private.param("publish_refresh_period", refresh_period, 0.5);
+
+    Pub_Vel.Advertise               (Nh, "robot/cmd_vel", 10, vel_max_rate, refresh_period);
+    Pub_Joy_Feedback.Advertise      (Nh, "/set_feedback", 10, feedback_max_rate, refresh_period);
+    Pub_Pure_Pursuit.Advertise      (Nh, "/pure_pursuit_pose", 10, pure_pursuit_max_rate, refresh_period);
+    Pub_Local_Desired_Vel.Advertise (Nh, "/main_controller/local_desired_vel", 10, local_vel_max_rate, refresh_period);
+    ControlCore::Config_t core_config = ControlCore::DefaultConfig();
+    Nh_Private.param("use_path_spline", core_config.use_path_spline, core_config.use_path_spline);
+    use_path_spline = core_config.use_path_spline;
+    Nh_Private.param("use_pose_predictor", use_pose_predictor, true);
+
+    // Path Tracking Controller, Switchable at Runtime While Stopped
+    std::string controller_name;
+    PathControllerConfig_t &ControllerConfig = core_config.controllers;
+    Nh_Private.param<std::string>("controller", controller_name, "lqr");
+    Nh_Private.param("lqr/q_position", ControllerConfig.lqr.q_position, ControllerConfig.lqr.q_position);
+    Nh_Private.param("lqr/q_theta", ControllerConfig.lqr.q_theta, ControllerConfig.lqr.q_theta);
+    Nh_Private.param("lqr/r", ControllerConfig.lqr.r, ControllerConfig.lqr.r);
+    Nh_Private.param("lqr/max_speed", ControllerConfig.lqr.max_speed, ControllerConfig.lqr.max_speed);
+    Nh_Private.param("mpc/reference_speed", core_config.mpc_reference_speed, core_config.mpc_reference_speed);
+    Nh_Private.param("mpc/dt", ControllerConfig.mpc.dt, ControllerConfig.mpc.dt);
+    Nh_Private.param("mpc/q_position", ControllerConfig.mpc.q_position, ControllerConfig.mpc.q_position);
+    Nh_Private.param("mpc/q_theta", ControllerConfig.mpc.q_theta, ControllerConfig.mpc.q_theta);
+    Nh_Private.param("mpc/r_speed", ControllerConfig.mpc.r_speed, ControllerConfig.mpc.r_speed);
+    Nh_Private.param("mpc/r_accel", ControllerConfig.mpc.r_accel, ControllerConfig.mpc.r_accel);
+    Nh_Private.param("mpc/max_speed", ControllerConfig.mpc.max_speed, ControllerConfig.mpc.max_speed);
+    Nh_Private.param("mpc/max_angular", ControllerConfig.mpc.max_angular, ControllerConfig.mpc.max_angular);
+    Nh_Private.param("mpc/max_accel", ControllerConfig.mpc.max_accel, ControllerConfig.mpc.max_accel);
+    Nh_Private.param("mpc/max_angular_accel", ControllerConfig.mpc.max_angular_accel, ControllerConfig.mpc.max_angular_accel);
+    Nh_Private.param("mpc/angular_scale", ControllerConfig.mpc.angular_scale, ControllerConfig.mpc.angular_scale);
+    Nh_Private.param("mpc/rho", ControllerConfig.mpc.rho, ControllerConfig.mpc.rho);
+    Nh_Private.param("mpc/max_iterations", ControllerConfig.mpc.max_iterations, ControllerConfig.mpc.max_iterations);
+
+    // Laser Check of the Commanded Velocity, Base Frame Geometry from the Static TF in controller.launch
+    ScanCollisionChecker::Config_t scan_config;
+    Nh_Private.param("use_scan_check", use_scan_check, true);
+    Nh_Private.param("scan_check_manual", core_config.scan_guard_manual, core_config.scan_guard_manual);
+    Nh_Private.param("scan_timeout", scan_timeout, 0.5);
+    Nh_Private.param("laser_offset_x", scan_config.laser_x, 0.12f);
+    Nh_Private.param("laser_offset_y", scan_config.laser_y, 0.0f);
+    Nh_Private.param("laser_yaw", scan_config.laser_yaw, 0.0f);
+    Nh_Private.param("robot_radius", scan_config.robot_radius, 0.3f);
+    Nh_Private.param("scan_self_radius", scan_config.self_radius, 0.0f);
+    Nh_Private.param("scan_stop_time", scan_config.stop_time, 0.3f);
+    Nh_Private.param("scan_slow_time", scan_config.slow_time, 1.5f);
+    Checker.Configure(scan_config);
+
+    // Occupancy Memory Around the Robot in Odom, Keeps Obstacles the Latest Scan Cannot See
+    double grid_size, grid_resolution;
+    Nh_Private.param("use_grid_check", use_grid_check, true);
+    Nh_Private.param("grid_size", grid_size, 4.0);
+    Nh_Private.param("grid_resolution", grid_resolution, 0.05);
+    Nh_Private.param("grid_check_time", core_config.grid_check_time, core_config.grid_check_time);
+    Grid.Configure(grid_size, grid_resolution, scan_config.robot_radius);
+    ScanGrid.Configure(grid_size, grid_resolution, scan_config.robot_radius);
+    laser_offset.x = scan_config.laser_x;
+    laser_offset.y = scan_config.laser_y;
+    laser_offset.theta = scan_config.laser_yaw;
+
+    // Translation Limit from Clearance Along the Command, Path Curvature and AMCL Covariance
+    SpeedGovernor::Config_t &GovernorConfig = core_config.governor;
+    Nh_Private.param("max_speed", core_config.max_speed, core_config.max_speed);
+    Nh_Private.param("use_speed_governor", core_config.use_speed_governor, core_config.use_speed_governor);
+    Nh_Private.param("governor/min_speed", GovernorConfig.min_speed, GovernorConfig.min_speed);
+    Nh_Private.param("governor/max_speed", GovernorConfig.max_speed, GovernorConfig.max_speed);
+    Nh_Private.param("governor/slow_clearance", GovernorConfig.slow_clearance, GovernorConfig.slow_clearance);
+    Nh_Private.param("governor/free_clearance", GovernorConfig.free_clearance, GovernorConfig.free_clearance);
+    Nh_Private.param("governor/max_lateral_accel", GovernorConfig.max_lateral_accel, GovernorConfig.max_lateral_accel);
+    Nh_Private.param("governor/curvature_lookahead", GovernorConfig.curvature_lookahead, GovernorConfig.curvature_lookahead);
+    Nh_Private.param("governor/good_position_std", GovernorConfig.good_position_std, GovernorConfig.good_position_std);
+    Nh_Private.param("governor/bad_position_std", GovernorConfig.bad_position_std, GovernorConfig.bad_position_std);
+
+    // Distance Field of the Stored Map for the Governor, Cached as an .edt File Next to the YAML
+    std::string clearance_map;
+    Nh_Private.param<std::string>("clearance_map", clearance_map, "");
+    core_config.footprint_radius = scan_config.robot_radius;
+    if (!clearance_map.empty())
+    {
+        OccupancyMap map;
+        std::string error;
+        bool from_cache;
+        if (!map.Load(clearance_map, error))
+        {
+            ROS_WARN("Clearance map not used: %s", error.c_str());
+        }
+        else
+        {
+            if (!MapClearance.LoadOrCompute(map, DistanceField::CachePath(clearance_map), true, 0, from_cache))
+            {
+                ROS_WARN("Cannot write the distance cache of %s", clearance_map.c_str());
+            }
+            use_map_clearance = true;
+            ROS_INFO("Clearance map %s, %dx%d cells (%s)", clearance_map.c_str(), MapClearance.Width(),
+                     MapClearance.Height(), from_cache ? "cached" : "computed");
+        }
+    }
+
+    // Line of Sight Shortcut and Corner Smoothing of Incoming Paths, Checked on the Clearance Map
+    PathShortcut::Config_t shortcut_config = Shortcut.Config();
+    Nh_Private.param("use_path_shortcut", use_path_shortcut, true);
+    Nh_Private.param("shortcut/inflation_radius", shortcut_config.inflation_radius, shortcut_config.inflation_radius);
+    Nh_Private.param("shortcut/smooth_iterations", shortcut_config.smooth_iterations, shortcut_config.smooth_iterations);
+    Nh_Private.param("shortcut/corner_cut", shortcut_config.corner_cut, shortcut_config.corner_cut);
+    Nh_Private.param("shortcut/max_spacing", shortcut_config.max_spacing, shortcut_config.max_spacing);
+    Shortcut.Configure(shortcut_config);
+    if (use_path_shortcut && !use_map_clearance)
+    {
+        ROS_WARN("Path shortcut needs ~clearance_map, incoming paths are tracked as they are");
+        use_path_shortcut = false;
+    }
+    if (use_path_shortcut)
+    {
+        Shortcut.SetMap(MapClearance);
+    }
+
+    // Wheel Layout for the Wheel Speed Limit, Angles in Degrees Counter-Clockwise from Forward.
+    // The Built-In Layout Is a Placeholder, the Limit Only Runs on Geometry Given Here
+    OmniKinematics::Config_t &KinematicsConfig = core_config.kinematics;
+    std::vector<double> wheel_angles;
+    bool have_layout = false;
+    Nh_Private.param("use_wheel_limit", core_config.use_wheel_limit, core_config.use_wheel_limit);
+    if (Nh_Private.getParam("kinematics/wheel_angles", wheel_angles))
+    {
+        if (wheel_angles.size() >= 3 && wheel_angles.size() <= (size_t)OmniKinematics::MAX_WHEELS)
+        {
+            KinematicsConfig.wheels = wheel_angles.size();
+            for (size_t i = 0; i < wheel_angles.size(); i++)
+            {
+                KinematicsConfig.wheel_angle[i] = wheel_angles[i] * M_PI / 180.0;
+            }
+            have_layout = true;
+        }
+        else
+        {
+            ROS_WARN("kinematics/wheel_angles needs 3 or 4 entries, keeping the default layout");
+        }
+    }
+    bool have_base  = Nh_Private.getParam("kinematics/base_radius", KinematicsConfig.base_radius);
+    bool have_wheel = Nh_Private.getParam("kinematics/wheel_radius", KinematicsConfig.wheel_radius);
+    bool have_speed = Nh_Private.getParam("kinematics/max_wheel_speed", KinematicsConfig.max_wheel_speed);
+    bool have_geometry = have_layout && have_base && have_wheel && have_speed;
+    Nh_Private.param("kinematics/angular_scale", KinematicsConfig.angular_scale, KinematicsConfig.angular_scale);
+    if (core_config.use_wheel_limit && !have_geometry)
+    {
+        ROS_WARN("use_wheel_limit needs kinematics/wheel_angles, base_radius, wheel_radius and max_wheel_speed, "
+                 "wheel speed limit off");
+        core_config.use_wheel_limit = false;
+    }
+    if (core_config.use_wheel_limit)
+    {
+        ROS_INFO("Wheel speed limit: %d wheels, base radius %.3f m, wheel radius %.3f m, max %.1f rad/s",
+                 KinematicsConfig.wheels, KinematicsConfig.base_radius, KinematicsConfig.wheel_radius,
+                 KinematicsConfig.max_wheel_speed);
+    }
+
+    Core.Configure(core_config);
+    if (!Core.RequestController(controller_name))
+    {
+        ROS_WARN("Unknown controller '%s', using lqr", controller_name.c_str());
+        Core.RequestController("lqr");
+    }
+    ROS_INFO("Path tracking controller: %s", Core.ControllerName());
+
+    // Core Inputs Start Released and Clear
+    CoreInput = ControlCore::Input_t();
+    CoreInput.path = NULL;
+
+    double      control_rate;
+    int         executor_priority;
+    std::string overrun_policy;
+    Nh_Private.param("control_rate", control_rate, 200.0);
+    Nh_Private.param("executor_priority", executor_priority, 0);
+    Nh_Private.param<std::string>("overrun_policy", overrun_policy, "skip");
+
+    bool        event_driven;
+    double      keep_alive_period;
+    Nh_Private.param("event_driven", event_driven, false);
+    Nh_Private.param("keep_alive_period", keep_alive_period, 0.2);
 
     // Initialize Speed Variable
     for (int i = 0; i <=2 ; i++)
     {
         vel_msg.data.push_back(0);
+        vel_msg.velocity.push_back(0.0);
+        vel_msg.accel.push_back(0.0);
     }
 
     // Initialize Joystick LED Feedback
@@ -51,276 +240,218 @@ Robot::Robot(): RosRate(200)
     MsgJoyFeedbackArray.array.push_back(MsgJoyLED_B);
     MsgJoyFeedbackArray.array.push_back(MsgJoyRumble);
 
-    // Initialize Pure Purusit
-    int path_left;
-    double distance_left;
+    // Run Control Tick on Its Own Deadline Timer, Callbacks Stay on the Spinner
+    Executor.EventMode(event_driven, keep_alive_period);
+    Executor.Start(control_rate,
+                   overrun_policy == "catch_up" ? ControlExecutor::CATCH_UP : ControlExecutor::SKIP,
+                   std::bind(&Robot::ControlTick, this),
+                   executor_priority);
+
+    // Publish Loop Timing Statistics Once per Second
+    Timer_Loop_Stats = Nh.createTimer(ros::Duration(1.0), &Robot::Loop_Stats_Event, this);
+
+    // Liveness for the Base Deadman, Only While the Control Loop Is Ticking
+    double heartbeat_rate;
+    Nh_Private.param("heartbeat_rate", heartbeat_rate, 10.0);
+    Nh_Private.param("heartbeat_tick_timeout", heartbeat_tick_timeout, std::max(0.5, 2.0 * keep_alive_period));
+    Pub_Heartbeat   = Nh.advertise<std_msgs::UInt32>("robot/cmd_heartbeat", 1);
+    Timer_Heartbeat = Nh.createTimer(ros::Duration(1.0 / heartbeat_rate), &Robot::Heartbeat_Event, this);
+
+    ros::spin();
+    Executor.Stop();
+};
 
-    while(ros::ok())
-    {   
-        // Print Robot Speed (DEBUG)
-        // std::cout << "x : " << robot_vel[0] << " y : " << robot_vel[1] << " Theta : " << robot_vel[2] << " Status : " << vel_msg.StatusControl << std::endl;
-        // std::cout << "pose= x: " << robot_pose.x << " y: " << robot_pose.y << " theta: " << robot_pose.theta*(180/MATH_PI) << std::endl;
+Robot::~Robot(){}
 
-        // Set Status Control using TRIANGLE Button
-        if (Controller.Buttons[TRIANGLE] == 0 && Controller.prev_button[TRIANGLE] == 1)
-        {
-            StatusControl ^= 1;
-            vel_msg.StatusControl = StatusControl;
-        }
-        Controller.prev_button[TRIANGLE] = Controller.Buttons[TRIANGLE];
+bool Robot::ControlTick()
+{
+    std::lock_guard<std::mutex> lock(StateMutex);
 
-        // Clear Path Generated using CIRCLE Button
-        if (Controller.Buttons[CIRCLE] == 0 && Controller.prev_button[CIRCLE] == 1)
-        {
-            ClearPath(path);
-        }
-        Controller.prev_button[CIRCLE] = Controller.Buttons[CIRCLE];
+    ros::Time now = ros::Time::now();
+    float dt = prev_tick_time.isZero() ? 0.0 : (now - prev_tick_time).toSec();
+    prev_tick_time = now;
 
-        // Set GUIDED/MANUAL Mode Using OPTIONS Button
-        if (Controller.Buttons[OPTIONS] == 0 && Controller.prev_button[OPTIONS] == 1)
-        {
-            GuidedMode ^= 1;
-            // Set Rumble Feedback
-            rumble_status = 1;
-            MsgJoyRumble.intensity  = 0.5;
-            prev_time = ros::Time::now();
-        }
-        Controller.prev_button[OPTIONS] = Controller.Buttons[OPTIONS];
+    // Fresh Map Pose from Last AMCL Correction Plus Odometry Since Then
+    PosePredictor::Pose_t predicted_pose;
+    if (use_pose_predictor && Predictor.Predict(predicted_pose))
+    {
+        robot_pose.x = predicted_pose.x;
+        robot_pose.y = predicted_pose.y;
+        robot_pose.theta = predicted_pose.theta;
+    }
 
-        // Reset local Odom
-        if (Controller.Buttons[SQUARE] == 0 && Controller.prev_button[SQUARE] == 1)
-        {
-            robot_pose_odom.x -= robot_pose_odom.x;
-            robot_pose_odom.y -= robot_pose_odom.y;
-            robot_pose_odom.theta -= robot_pose_odom.theta;
-        }
-        Controller.prev_button[SQUARE] = Controller.Buttons[SQUARE];
+    // Commands Trace Back to the Oldest Input Since the Last Tick, or to the Tick Itself
+    ros::Time origin_stamp = input_stamp.isZero() ? now : input_stamp;
+    input_stamp = ros::Time();
 
-        // Set RTH Mode Using SHARE Button
-        if (Controller.Buttons[SHARE] == 1 && Controller.prev_button[SHARE] == 0)
-        {
-            // Clear Current Path
-            ClearPath(path);
-
-            // Add Header Goal Message
-            origin_msg.header.stamp = ros::Time::now();
-            origin_msg.header.frame_id = "map";
-
-            // Set Goal to Origin Position
-            origin_msg.pose.position.x = 0.0;
-            origin_msg.pose.position.y = 0.0;
-            origin_msg.pose.position.z = 0.0;
-
-            // Set Goal to Zero Degree Orientation
-            origin_msg.pose.orientation.x = 0.0;
-            origin_msg.pose.orientation.y = 0.0;
-            origin_msg.pose.orientation.z = 0.0;
-            origin_msg.pose.orientation.w = 1.0;
-
-            // Publish Goal Message
-            Pub_Origin.publish(origin_msg);
-
-            // Set Rumble Feedback
-            rumble_status = 1;
-            MsgJoyRumble.intensity  = 0.5;
-            prev_time = ros::Time::now();
-        }
-        Controller.prev_button[SHARE] = Controller.Buttons[SHARE];
+    // Hand a New Path to the Core, It Returns the Old One in pending_path
+    CoreInput.pose = robot_pose;
+    bool scan_fresh = !scan_time.isZero() && (now - scan_time).toSec() < scan_timeout;
+    CoreInput.scan = (use_scan_check && scan_fresh) ? &Checker : NULL;
+    CoreInput.grid = (use_grid_check && scan_fresh) ? &Grid : NULL;
+    CoreInput.odom_pose = robot_pose_odom;
+    CoreInput.clearance_map = use_map_clearance ? &MapClearance : NULL;
+    CoreInput.path = path_pending ? &pending_path : NULL;
+    path_pending = false;
 
-        // Rumble Feedback Event
-        if (rumble_status && ros::Time::now() - prev_time >= ros::Duration(0.57))
-        {
-            MsgJoyRumble.intensity  = 0.0;
-            rumble_status = 0;
-        }
+    const ControlCore::Output_t &out = Core.Step(CoreInput, dt);
 
-        // // Clear Path if Robot CRASHED
-        // if (prev_crashed == 0 && crashed_status == 1)
-        // {
-        //     // DEBUG
-        //     ClearPath(path);
-        //     ROS_INFO("Robot stopped because path is closed. Recalculating path... ");
-        // }
-        prev_crashed = crashed_status;
-
-        // Go to Autonomous Mode
-        if (GuidedMode)
-        {
-            // Go to AUTONOMOUS Mode with Indicator
-            if (vel_msg.StatusControl)
-            {
-                // Set YELLOW Indicator for GUIDED Mode
-                MsgJoyLED_R.intensity = 0.3;
-                MsgJoyLED_G.intensity = 0.3;
-                MsgJoyLED_B.intensity = 0.0;
-
-                // Prevent going to origin if there's no path
-                if(path.x.size() <= 0)
-                {
-                    robot_vel[0] = 0.0;
-                    robot_vel[1] = 0.0;
-                    robot_vel[2] = 0.0;
-                }
-
-                // Search for Closest Node using Pure Pursuit
-                else
-                {
-                    next_pose = PurePursuit(robot_pose, path, 0.1, obstacle_status);
-
-                    // Push Pure Pursuit Next Target to Publisher Messages
-                    tf2::Quaternion next_theta;
-                    next_theta.setRPY(0, 0, next_pose.theta);
-                    next_theta = next_theta.normalize();
-
-                    pure_pursuit_msg.header.frame_id  = "map";
-                    pure_pursuit_msg.pose.position.x  = next_pose.x;
-                    pure_pursuit_msg.pose.position.y  = next_pose.y;
-                    pure_pursuit_msg.pose.orientation.x = next_theta.x();
-                    pure_pursuit_msg.pose.orientation.y = next_theta.y();
-                    pure_pursuit_msg.pose.orientation.z = next_theta.z();
-                    pure_pursuit_msg.pose.orientation.w = next_theta.w();
-
-                    // PID Controller
-                    // pure_pursuit_vel = PointToPointPID(robot_pose, next_pose);
-
-                    //PID Controller by Nawab
-                    // pure_pursuit_vel = PointToPointPIDV2(robot_pose, next_pose);
-
-                    // LQR Controller
-                    pure_pursuit_vel = PointToPointLQR(robot_pose, next_pose, 30);
-
-                    // Convert Pure Pursuit Velocity to Local Velocity
-                    local_vel = Global_to_Local_Vel(robot_pose, pure_pursuit_vel);
-                    robot_vel[0] = local_vel.x;
-                    robot_vel[1] = local_vel.y;
-                    robot_vel[2] = local_vel.theta;
-
-                    // Push Local Velocity to Publisher
-                    local_desired_vel_msg.linear.x = local_vel.x * cos(MATH_PI/2) + local_vel.y * sin(MATH_PI/2);
-                    local_desired_vel_msg.linear.y = -1 * local_vel.x * sin(MATH_PI/2) + local_vel.y * cos(MATH_PI/2);
-                    local_desired_vel_msg.angular.z = local_vel.theta;
-
-                    // Obstacle Avoidance Control with WHITE Indicator
-                    if(obstacle_status)
-                    {
-                        // Set LED Feedback
-                        MsgJoyLED_R.intensity = 1.0;
-                        MsgJoyLED_G.intensity = 1.0;
-                        MsgJoyLED_B.intensity = 1.0;
-
-                        robot_vel[0] = obstacle_avoider_vel.x * cos(MATH_PI/2) - obstacle_avoider_vel.y * sin(MATH_PI/2);
-                        robot_vel[1] = obstacle_avoider_vel.x * sin(MATH_PI/2) + obstacle_avoider_vel.y * cos(MATH_PI/2);
-                        robot_vel[2] = obstacle_avoider_vel.theta;
-                    }
-                }
-                
-            }
+    if (out.controller_switched)
+    {
+        ROS_INFO("Path tracking controller switched to %s", Core.ControllerName());
+    }
+    if (out.path_finished)
+    {
+        ROS_INFO("Path Finished!");
+    }
+    if (out.collision_scale <= 0.0)
+    {
+        ROS_WARN_THROTTLE(1.0, "Stopped by scan check, contact in %.2f s", out.time_to_collision);
+    }
+    if (out.grid_blocked)
+    {
+        ROS_WARN_THROTTLE(1.0, "Stopped by grid check, footprint ahead is occupied");
+    }
 
-            // Pause AUTONOMOUS Mode with RED Indicator
-            else
-            {
-                // Set LED Feedback
-                MsgJoyLED_R.intensity = 1.0;
-                MsgJoyLED_G.intensity = 0.0;
-                MsgJoyLED_B.intensity = 0.13;  
-
-                // Push Local Velocity Publisher to Zero
-                local_desired_vel_msg.linear.x = 0.0;
-                local_desired_vel_msg.linear.y = 0.0;
-                local_desired_vel_msg.angular.z = 0.0;
-
-                // Set Robot Speed to Zero (Safety Issues)
-                for(int i = 0; i<=2; i++)
-                {
-                    robot_vel[i] = 0;
-                }    
-            }
-        }
+    // Reset local Odom
+    if (out.reset_odom)
+    {
+        robot_pose_odom.x = 0.0;
+        robot_pose_odom.y = 0.0;
+        robot_pose_odom.theta = 0.0;
+    }
 
-        // Go to Manual Control Mode
-        else 
-        {
-            // Go to Manual Control RUN Mode with GREEN Indicator
-            if (vel_msg.StatusControl)
-            {
-                // Set LED Feedback
-                MsgJoyLED_R.intensity = 0.12;
-                MsgJoyLED_G.intensity = 0.75;
-                MsgJoyLED_B.intensity = 0.13;
-
-                // Set Robot Speed from Joy Axis
-                robot_vel[0] = -1 * Controller.Axis[0] * 45;
-                robot_vel[1] = Controller.Axis[1] * 45;
-                robot_vel[2] = Controller.Axis[2] * 20;
-            }
+    // Set RTH Mode, Goal at the Origin with Zero Degree Orientation
+    if (out.go_home)
+    {
+        origin_msg.header.stamp = now;
+        origin_msg.header.frame_id = "map";
+        origin_msg.pose.position.x = 0.0;
+        origin_msg.pose.position.y = 0.0;
+        origin_msg.pose.position.z = 0.0;
+        origin_msg.pose.orientation.x = 0.0;
+        origin_msg.pose.orientation.y = 0.0;
+        origin_msg.pose.orientation.z = 0.0;
+        origin_msg.pose.orientation.w = 1.0;
+        Pub_Origin.publish(origin_msg);
+    }
 
-            // Go to Manual Control LOCK Mode with RED Indicator
-            else
-            {
-                // Set LED Feedback
-                MsgJoyLED_R.intensity = 1.0;
-                MsgJoyLED_G.intensity = 0.0;
-                MsgJoyLED_B.intensity = 0.13;     
-
-                // Set Robot Speed to Zero (Safety Issues)
-                for(int i = 0; i<=2; i++)
-                {
-                    robot_vel[i] = 0;
-                }     
-            }
-        }
+    // Core Outputs to Messages
+    vel_msg.header.stamp = origin_stamp;
+    vel_msg.seq = command_seq + 1;
+    vel_msg.tick_stamp = now;
+    vel_msg.StatusControl = out.status_control;
+    for(int i = 0 ; i<=2 ; i++)
+    {
+        vel_msg.data.at(i) = out.command[i];
+        vel_msg.velocity.at(i) = out.velocity[i];
+        vel_msg.accel.at(i) = out.accel[i];
+    }
 
-        // Limit Robot Speed to 30 cm/s
-        for(int i = 0 ; i<=2 ; i++)
-        {
-            vel_msg.data.at(i) = robot_vel[i];
-            if(vel_msg.data.at(i) >= 30)
-            {
-                vel_msg.data.at(i) = 30;
-            }
-            else if(vel_msg.data.at(i) <= -30)
-            {
-                vel_msg.data.at(i) = -30;
-            }
-        }
+    tf2::Quaternion next_theta;
+    next_theta.setRPY(0, 0, out.target.theta);
+    next_theta = next_theta.normalize();
+
+    pure_pursuit_msg.header.frame_id  = "map";
+    pure_pursuit_msg.pose.position.x  = out.target.x;
+    pure_pursuit_msg.pose.position.y  = out.target.y;
+    pure_pursuit_msg.pose.orientation.x = next_theta.x();
+    pure_pursuit_msg.pose.orientation.y = next_theta.y();
+    pure_pursuit_msg.pose.orientation.z = next_theta.z();
+    pure_pursuit_msg.pose.orientation.w = next_theta.w();
+
+    local_desired_vel_msg.linear.x = out.local_desired_vel.x;
+    local_desired_vel_msg.linear.y = out.local_desired_vel.y;
+    local_desired_vel_msg.angular.z = out.local_desired_vel.theta;
+
+    MsgJoyLED_R.intensity   = out.led[0];
+    MsgJoyLED_G.intensity   = out.led[1];
+    MsgJoyLED_B.intensity   = out.led[2];
+    MsgJoyRumble.intensity  = out.rumble;
+
+    MsgJoyFeedbackArray.array.at(0) = MsgJoyLED_R;
+    MsgJoyFeedbackArray.array.at(1) = MsgJoyLED_G;
+    MsgJoyFeedbackArray.array.at(2) = MsgJoyLED_B;
+    MsgJoyFeedbackArray.array.at(3) = MsgJoyRumble;
+
+    // Publish Topics, Trace Fields and the Command Number Alone Do Not Make a New Command
+    uint32_t trace_length = ros::serialization::serializationLength(vel_msg.header) +
+                            ros::serialization::serializationLength(vel_msg.seq) +
+                            ros::serialization::serializationLength(vel_msg.tick_stamp) +
+                            ros::serialization::serializationLength(vel_msg.publish_stamp);
+    vel_msg.publish_stamp = ros::Time::now();
+    if (Pub_Vel.Publish(vel_msg, trace_length))
+    {
+        command_seq++;
+    }
+    Pub_Pure_Pursuit.Publish(pure_pursuit_msg);
+    Pub_Joy_Feedback.Publish(MsgJoyFeedbackArray);
+    Pub_Local_Desired_Vel.Publish(local_desired_vel_msg);
 
-        MsgJoyFeedbackArray.array.at(0) = MsgJoyLED_R;
-        MsgJoyFeedbackArray.array.at(1) = MsgJoyLED_G;
-        MsgJoyFeedbackArray.array.at(2) = MsgJoyLED_B;
-        MsgJoyFeedbackArray.array.at(3) = MsgJoyRumble;
+    // A Change Held Back by the Rate Limit Goes Out on a Later Tick, Not After the Refresh Period
+    return out.keep_ticking || Pub_Vel.Held() || Pub_Pure_Pursuit.Held() || Pub_Joy_Feedback.Held() ||
+           Pub_Local_Desired_Vel.Held();
+}
 
-        // Publish Topics
-        
-        Pub_Vel.publish(vel_msg);
-        Pub_Pure_Pursuit.publish(pure_pursuit_msg);
-        Pub_Joy_Feedback.publish(MsgJoyFeedbackArray);
-        Pub_Local_Desired_Vel.publish(local_desired_vel_msg);
+void Robot::Loop_Stats_Event(const ros::TimerEvent &event)
+{
+    ControlExecutor::Stats_t stats = Executor.GetStats(true);
+
+    loop_stats_msg.header.stamp = ros::Time::now();
+    loop_stats_msg.ticks        = stats.ticks;
+    loop_stats_msg.missed       = stats.missed;
+    loop_stats_msg.skipped      = stats.skipped;
+    loop_stats_msg.idle_wakeups = stats.idle_wakeups;
+    loop_stats_msg.period_mean  = stats.period_mean;
+    loop_stats_msg.period_min   = stats.period_min;
+    loop_stats_msg.period_max   = stats.period_max;
+    loop_stats_msg.compute_mean = stats.compute_mean;
+    loop_stats_msg.compute_max  = stats.compute_max;
+    loop_stats_msg.jitter_max   = stats.jitter_max;
+
+    Pub_Loop_Stats.publish(loop_stats_msg);
+}
 
-        ros::spinOnce(); 
-        RosRate.sleep();
-    }
-};
+void Robot::Heartbeat_Event(const ros::TimerEvent &event)
+{
+    {
+        std::lock_guard<std::mutex> lock(StateMutex);
 
-Robot::~Robot(){}
+        // A Stalled Tick Must Let the Base Time Out Even Though This Node Is Alive
+        if (prev_tick_time.isZero() || (ros::Time::now() - prev_tick_time).toSec() > heartbeat_tick_timeout)
+        {
+            return;
+        }
+        heartbeat_msg.data = command_seq;
+    }
+    Pub_Heartbeat.publish(heartbeat_msg);
+}
 
 void Robot::Joy_Callback (const sensor_msgs::Joy::ConstPtr &joy_msg)
 {
-    for(int i = 0; i<4; i++)
     {
-        Controller.Axis[i] = joy_msg->axes[i];
-    }
+        std::lock_guard<std::mutex> lock(StateMutex);
+        for(int i = 0; i<ControlCore::NUM_AXES && i<joy_msg->axes.size(); i++)
+        {
+            CoreInput.axes[i] = joy_msg->axes[i];
+        }
 
-    for(int i = 0; i<18; i++)
-    {
-        Controller.Buttons[i] = joy_msg->buttons[i];
+        for(int i = 0; i<ControlCore::NUM_BUTTONS && i<joy_msg->buttons.size(); i++)
+        {
+            CoreInput.buttons[i] = joy_msg->buttons[i];
+        }
+        Mark_Input_Stamp(joy_msg->header.stamp);
     }
+    Executor.Notify();
 }
 
 void Robot::Path_Callback (const nav_msgs::Path::ConstPtr &path_msg)
 {
-    ClearPath(path);
+    // Build New Path Outside the Lock so a Big Path Does Not Stall the Control Tick
+    Path_t new_path;
     double  roll, pitch, yaw;
 
+    raw_path.resize(path_msg->poses.size());
     for(int i = 0; i < path_msg->poses.size(); ++i)
     {
         // Convert Quaternion to Euler Yaw (Rad)
@@ -332,12 +463,53 @@ void Robot::Path_Callback (const nav_msgs::Path::ConstPtr &path_msg)
         tf::Matrix3x3 m(q);
 
         m.getRPY(roll, pitch, yaw);
+        raw_path[i].x = path_msg->poses[i].pose.position.x;
+        raw_path[i].y = path_msg->poses[i].pose.position.y;
+        raw_path[i].theta = yaw;
+    }
+
+    // Staircase Runs of Grid Planners Become Straight Segments with Rounded Corners
+    if(use_path_shortcut)
+    {
+        auto start = std::chrono::steady_clock::now();
+        Shortcut.Process(raw_path, short_path);
+        double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        const PathShortcut::Stats_t &stats = Shortcut.Stats();
+        ROS_INFO("Path shortcut: %d -> %d poses, %.2f -> %.2f m in %.0f us", stats.input_points, stats.output_points,
+                 stats.input_length, stats.output_length, elapsed);
+    }
+    const std::vector<PathShortcut::Point_t> &points = use_path_shortcut ? short_path : raw_path;
+
+    std::vector<float> waypoint_x, waypoint_y, waypoint_theta;
+    waypoint_x.reserve(points.size());
+    waypoint_y.reserve(points.size());
+    waypoint_theta.reserve(points.size());
+    for(const PathShortcut::Point_t &point : points)
+    {
         // Push Subscriber Topics to Path Array
-        path.x.push(path_msg->poses[i].pose.position.x);
-        path.y.push(path_msg->poses[i].pose.position.y);
-        path.theta.push(yaw);    
+        new_path.x.push(point.x);
+        new_path.y.push(point.y);
+        new_path.theta.push(point.theta);
 
+        waypoint_x.push_back(point.x);
+        waypoint_y.push_back(point.y);
+        waypoint_theta.push_back(point.theta);
     }
+
+    // Fit Continuous Path so Sparse Waypoints Can Be Tracked
+    if(use_path_spline)
+    {
+        new_path.curve.Fit(waypoint_x, waypoint_y, waypoint_theta);
+    }
+
+    // Taken by the Next Tick, Whatever It Replaces Is Freed Here Outside the Lock
+    {
+        std::lock_guard<std::mutex> lock(StateMutex);
+        SwapTrackingPath(pending_path, new_path);
+        path_pending = true;
+        Mark_Input_Stamp(path_msg->header.stamp);
+    }
+    Executor.Notify();
 }
 
 void Robot::Pose_Callback (const geometry_msgs::PoseWithCovarianceStamped::ConstPtr &pose_msg)
@@ -354,9 +526,20 @@ void Robot::Pose_Callback (const geometry_msgs::PoseWithCovarianceStamped::Const
 
     m.getRPY(roll, pitch, yaw);
     // Push Subscriber Topics to Current Robot Pose Variable
-    robot_pose.x = pose_msg->pose.pose.position.x;
-    robot_pose.y = pose_msg->pose.pose.position.y;   
-    robot_pose.theta = yaw;
+    {
+        std::lock_guard<std::mutex> lock(StateMutex);
+        robot_pose.x = pose_msg->pose.pose.position.x;
+        robot_pose.y = pose_msg->pose.pose.position.y;   
+        robot_pose.theta = yaw;
+
+        // Position Uncertainty Along the Worse Axis
+        CoreInput.position_std = sqrt(std::max(pose_msg->pose.covariance[0], pose_msg->pose.covariance[7]));
+
+        PosePredictor::Pose_t map_pose = {robot_pose.x, robot_pose.y, robot_pose.theta};
+        Predictor.SetMapPose(pose_msg->header.stamp.toSec(), map_pose);
+        Mark_Input_Stamp(pose_msg->header.stamp);
+    }
+    Executor.Notify();
 }
 
 void Robot::Pose_Odom_Callback (const nav_msgs::Odometry::ConstPtr &pose_msg)
@@ -373,407 +556,105 @@ void Robot::Pose_Odom_Callback (const nav_msgs::Odometry::ConstPtr &pose_msg)
 
     m.getRPY(roll, pitch, yaw);
     // Push Subscriber Topics to Current Robot Pose Variable
+    std::lock_guard<std::mutex> lock(StateMutex);
     robot_pose_odom.x = pose_msg->pose.pose.position.x;
     robot_pose_odom.y = pose_msg->pose.pose.position.y;   
     robot_pose_odom.theta = yaw;
+
+    PosePredictor::Pose_t odom_pose = {(float)pose_msg->pose.pose.position.x, (float)pose_msg->pose.pose.position.y, (float)yaw};
+    Predictor.AddOdom(pose_msg->header.stamp.toSec(), odom_pose);
 }
 
 void Robot::Obstacle_Status_Callback (const std_msgs::Bool::ConstPtr &obs_status_msg)
 {
-    obstacle_status = obs_status_msg->data;
+    {
+        std::lock_guard<std::mutex> lock(StateMutex);
+        CoreInput.obstacle = obs_status_msg->data;
+    }
+    Executor.Notify();
 }
 
 void Robot::Crashed_Status_Callback (const std_msgs::Bool::ConstPtr &crashed_msg)
 {
-    crashed_status = crashed_msg->data;
+    {
+        std::lock_guard<std::mutex> lock(StateMutex);
+        CoreInput.crashed = crashed_msg->data;
+    }
+    Executor.Notify();
 }
 
 void Robot::Obstacle_Vel_Callback    (const geometry_msgs::Twist::ConstPtr &obs_vel_msg)
 {
-    obstacle_avoider_vel.x = obs_vel_msg->linear.x;
-    obstacle_avoider_vel.y = obs_vel_msg->linear.y;
-    obstacle_avoider_vel.theta = obs_vel_msg->angular.z;
-}
-
-void Robot::ClearPath(Path_t &path)
-{
-    while(!path.x.empty())
     {
-        path.x.pop();
-        path.y.pop();
-        path.theta.pop();
+        std::lock_guard<std::mutex> lock(StateMutex);
+        CoreInput.obstacle_vel.x = obs_vel_msg->linear.x;
+        CoreInput.obstacle_vel.y = obs_vel_msg->linear.y;
+        CoreInput.obstacle_vel.theta = obs_vel_msg->angular.z;
     }
+    Executor.Notify();
 }
 
-Robot::Pose_t Robot::PurePursuit(Pose_t robot_pose, Path_t &path, float offset, bool obstacle)
+void Robot::Set_Controller_Callback (const std_msgs::String::ConstPtr &controller_msg)
 {
-
-    Pose_t target_pose;
-    target_pose = robot_pose;
-
-    float distance = 0.0;
-    float delta_heading = 0.0;
-    float theta_error = 0.0;
-    float dx, dy, dot_product;
-    int pathLeft = path.x.size();
-
-    // // Collision Avoidance Mode
-    if(obstacle)
     {
-        offset *= 10;
-        while(pathLeft > 1)
-        {
-            // Check for lookahead point
-            target_pose.x = path.x.front();
-            target_pose.y = path.y.front();
-            target_pose.theta = path.theta.front();
-            distance = sqrt(pow((target_pose.x - robot_pose.x), 2) + pow((target_pose.y - robot_pose.y), 2));
-
-            // Check if the path point is behind the vehicle
-            dx = target_pose.x - robot_pose.x;
-            dy = target_pose.y - robot_pose.y;
-            dot_product = dx * cos(robot_pose.theta) + dy * sin(robot_pose.theta);
-
-            if(distance >= offset && dot_product > 0)
-            {
-                return target_pose;
-            }
-            else
-            {
-                path.x.pop(); path.y.pop(); path.theta.pop();
-            }
-        }
-        // If Path Left is 1
-        target_pose.x = path.x.front();
-        target_pose.y = path.y.front();
-        target_pose.theta = path.theta.front();
-
-        // Check Distance and Theta Error for Last Target Point
-        distance = sqrt(pow((target_pose.x - robot_pose.x), 2) + pow((target_pose.y - robot_pose.y), 2));
-        theta_error = target_pose.theta - robot_pose.theta;
-        
-        if(abs(theta_error) >= MATH_PI)
+        std::lock_guard<std::mutex> lock(StateMutex);
+        if (!Core.RequestController(controller_msg->data))
         {
-            if(theta_error > 0)
-            {
-                theta_error = theta_error - 2*MATH_PI;
-            }
-            else
-            {
-                theta_error = theta_error + 2*MATH_PI;
-            }
+            ROS_WARN("Unknown controller '%s', keeping %s", controller_msg->data.c_str(), Core.ControllerName());
         }
-
-        //Untuk Nawab 
-        //(distance <= 0.1 && theta_error <= MATH_PI/18 && theta_error >= -MATH_PI/18)
-        if(distance <= 0.033 && theta_error <= MATH_PI/36 && theta_error >= -MATH_PI/36)
+        else if (!Core.Tracking())
         {
-            // Stop the Robot and Clear Path
-            path.x.pop(); target_pose.x = robot_pose.x;
-            path.y.pop(); target_pose.y = robot_pose.y;
-            path.theta.pop(); target_pose.theta = robot_pose.theta;
-            ROS_INFO("Path Finished!");
+            ROS_INFO("Path tracking controller switched to %s", Core.ControllerName());
         }
     }
-
-    // Normal Mode
-    else
-    {
-        // Define Next Target Pose
-        target_pose.x = path.x.front();
-        target_pose.y = path.y.front();
-        target_pose.theta = path.theta.front();
-
-        // Check for Distance Error
-        distance = sqrt(pow((path.x.front() - robot_pose.x), 2) + pow((path.y.front() - robot_pose.y), 2));
-        
-        // Check for Theta Error
-        // delta_heading = path.theta.front() - robot_pose.theta;        
-        // if(abs(delta_heading) >= MATH_PI)
-        // {
-        //     if(delta_heading > 0)
-        //     {
-        //         delta_heading = delta_heading - 2*MATH_PI;
-        //     }
-        //     else
-        //     {
-        //         delta_heading = delta_heading + 2*MATH_PI;
-        //     }
-        // }  
-
-        if(pathLeft > 1)
-        {   
-            while(distance < offset)
-            {
-                path.x.pop(); target_pose.x = path.x.front();
-                path.y.pop(); target_pose.y = path.y.front();  
-                path.theta.pop(); target_pose.theta = path.theta.front();
-                if(path.x.size() <= 1)
-                    break;
-                distance = sqrt(pow((target_pose.x - robot_pose.x), 2) + pow((target_pose.y - robot_pose.y), 2));
-            }
-        }
-
-        else
-        {
-            target_pose.x = path.x.front();
-            target_pose.y = path.y.front();
-            target_pose.theta = path.theta.front()/* - 180 * (MATH_PI/180)*/;
-
-            // Check Distance and Theta Error for Last Target Point
-            distance = sqrt(pow((target_pose.x - robot_pose.x), 2) + pow((target_pose.y - robot_pose.y), 2));
-            theta_error = target_pose.theta - robot_pose.theta;
-            
-            if(abs(theta_error) >= MATH_PI)
-            {
-                if(theta_error > 0)
-                {
-                    theta_error = theta_error - 2*MATH_PI;
-                }
-                else
-                {
-                    theta_error = theta_error + 2*MATH_PI;
-                }
-            }
-
-            if(distance <= 0.033 && theta_error <= MATH_PI/36 && theta_error >= -MATH_PI/36)
-            {
-            // Stop the Robot and Clear Path
-            path.x.pop(); target_pose.x = robot_pose.x;
-            path.y.pop(); target_pose.y = robot_pose.y;
-            path.theta.pop(); target_pose.theta = robot_pose.theta;
-
-            // Set Rumble Feedback
-            rumble_status = 1;
-            MsgJoyRumble.intensity  = 0.5;
-            prev_time = ros::Time::now();
-
-            ROS_INFO("Path Finished!");
-            }
-        }
-    }
-    return target_pose;
+    Executor.Notify();
 }
 
-Robot::Pose_t Robot::PointToPointPID(Pose_t robot_pose, Pose_t target_pose)
+void Robot::Scan_Callback (const sensor_msgs::LaserScan::ConstPtr &scan_msg)
 {
-    Pose_t robot_vel;
-    robot_vel.x = robot_vel.y = robot_vel.theta = 0.0;
-
-    float output[3] = {0.0, 0.0, 0.0};
-
-    float proportional[3] = {0.0, 0.0, 0.0};
-    float integral[3] = {0.0, 0.0, 0.0};
-    float derivative [3]= {0.0, 0.0, 0.0};
-
-    float error[3] = {0.0, 0.0, 0.0};
-    static float prevError[3] = {0.0, 0.0, 0.0};
-    static float sumError[3] = {0.0, 0.0, 0.0};
-
-    float kp[3] = {2.3, 2.3, 0.2}; //{2.5, 2.5, 0.2}
-    float ki[3] = {0.0, 0.0, 0.0}; // {0.0005, 0.0005, 0.0};
-    float kd[3] = {1.8, 1.8, 0.13}; // {1.8, 1.8, 0.13}
-
-
-    error[0] = target_pose.x - robot_pose.x;
-    error[1] = target_pose.y - robot_pose.y;
-    error[2] = target_pose.theta - robot_pose.theta;
-
-    if(abs(error[2]) >= MATH_PI){
-        if(error[2] > 0){
-            error[2] = error[2] - 2*MATH_PI;
-        }
-        else{
-            error[2] = error[2] + 2*MATH_PI;
-        }
-    }
-
-    for(int i=0 ; i<=2 ; i++){
-        sumError[i] += error[i];
-
-        proportional[i] = kp[i] * error[i];
-        integral[i] = ki[i] * sumError[i];
-        derivative[i] = kd[i] * (error[i] - prevError[i]);
-
-        prevError[i] = error[i];
-
-        output[i] = proportional[i] + integral[i] + derivative[i];
-    }
-
-    // Get Theta Control Only if Heading Error more than 36 degree
-    if(error[2] >= MATH_PI/6 || error[2] <= -MATH_PI/6)
+    if (use_grid_check)
     {
-        output[0] = 0.0;
-        output[1] = 0.0;
-    }
-    
-    robot_vel.x = output[0]*100;
-    robot_vel.y = output[1]*100;
-    robot_vel.theta = output[2]*100;
-
-    return robot_vel;
-}
-
-Robot::Pose_t Robot::PointToPointPIDV2(Pose_t robot_pose, Pose_t target_pose){
-    Pose_t robot_vel;
-
-    robot_vel.x = robot_vel.y = robot_vel.theta = 0.0;
-
-    float output[2] = {0.0, 0.0};
-
-    float proportional[2] = {0.0, 0.0};
-    float integral[2] = {0.0, 0.0};
-    float derivative [2]= {0.0, 0.0};
-    
-    float error[2] = {0.0, 0.0}; //Error Heading = [0], Error Distance = [1]
-    static float prevError[2] = {0.0, 0.0};
-    static float sumError[2] = {0.0, 0.0};
-
-    float kp[2] = {0.2, 0.5};
-    float ki[2] = {0, 0};
-    float kd[2] = {0.17, 0};
-
-    error[0] = atan2((target_pose.y - robot_pose.y), (target_pose.x - robot_pose.x));
-    error[1] = sqrt(pow((target_pose.x - robot_pose.y), 2) + pow((target_pose.y - robot_pose.y), 2));
-
-    for(int i=0 ; i<=1 ; i++){
-        sumError[i] += error[i];
-
-        proportional[i] = kp[i] * error[i];
-        integral[i] = ki[i] * sumError[i];
-        derivative[i] = kd[i] * (error[i] - prevError[i]);
-
-        prevError[i] = error[i];
-
-        output[i] = proportional[i] + integral[i] + derivative[i];
-    }
-
-    robot_vel.theta = output[0];
-    robot_vel.x = output[1]*100;
-    robot_vel.y = 0;
-
-    std::cout << "[" << robot_vel.x << "," << robot_vel.y << "," << robot_vel.theta << "]" << std :: endl;
-    return robot_vel;
-}
-
-Robot::Pose_t Robot::PointToPointLQR(Pose_t robot_pose, Pose_t target_pose, float maxSpeed)
-{
-    const int maxIterations = 100;
-    const double convergenceThreshold = 1e-6;
-
-    float error[3] = {0, 0, 0};
-    float output[3] = {0, 0, 0};
-    float dt = 1;
-
-    Pose_t robot_vel;
-    robot_vel.x = robot_vel.y = robot_vel.theta = 0;
-
-
-    error[0] = target_pose.x - robot_pose.x;
-    error[1] = target_pose.y - robot_pose.y;
-    error[2] = target_pose.theta - robot_pose.theta;
-
-    // Nearest Angle
-    if(abs(error[2]) >= MATH_PI){
-        if(error[2] > 0){
-            error[2] = error[2] - 2*MATH_PI;
-        }
-        else{
-            error[2] = error[2] + 2*MATH_PI;
+        RollingBitGrid::Pose_t odom;
+        {
+            std::lock_guard<std::mutex> lock(StateMutex);
+            odom.x = robot_pose_odom.x;
+            odom.y = robot_pose_odom.y;
+            odom.theta = robot_pose_odom.theta;
         }
-    }
 
-    // Define the system dynamics matrices A, B
-    Eigen::MatrixXd A(3, 3);
-    A << 1, 0, 0,
-         0, 1, 0,
-         0, 0, 1;
-
-    Eigen::MatrixXd B(3, 3);
-    B << -1*dt,     0,     0,
-             0, -1*dt,     0,
-             0,     0, -1*dt;
-
-    // Define the Q and R matrices
-    // P2P Q = diag(30, 30, 10)
-    // PTrack diag(225, 225, 50)
-    Eigen::MatrixXd Q(3, 3);
-    Q << 225, 0, 0,
-         0, 225, 0,
-         0, 0, 50;
-
-    Eigen::MatrixXd R(3, 3);
-    R << 1, 0, 0,
-         0, 1, 0,
-         0, 0, 1;
-
-    // Solve the Algebraic Riccati Equation
-    Eigen::MatrixXd P = Q;
-
-    // Perform the iterative computation
-    for (int i = 0; i < maxIterations; ++i) {
-        Eigen::MatrixXd P_prev = P;
-        P = A.transpose() * P * A - A.transpose() * P * B * (R + B.transpose() * P * B).inverse() * B.transpose() * P * A + Q;
-        // std::cout << P << std::endl;
-
-        // Check for convergence
-        double normDiff = (P - P_prev).norm();
-        if (normDiff < convergenceThreshold) {
-            std::cout << "Convergence achieved after " << i+1 << " iterations." << std::endl;
-            break;
-        }
+        // Ray Marking Takes Hundreds of Microseconds, so It Runs Without the Lock the Tick Needs
+        float c = cos(odom.theta);
+        float s = sin(odom.theta);
+        RollingBitGrid::Pose_t laser_pose;
+        laser_pose.x = odom.x + laser_offset.x * c - laser_offset.y * s;
+        laser_pose.y = odom.y + laser_offset.x * s + laser_offset.y * c;
+        laser_pose.theta = odom.theta + laser_offset.theta;
+
+        ScanGrid.Scroll(odom.x, odom.y);
+        ScanGrid.InsertScan(laser_pose, scan_msg->angle_min, scan_msg->angle_increment, scan_msg->ranges.data(),
+                            scan_msg->ranges.size(), scan_msg->range_min, scan_msg->range_max);
     }
 
-    // Calculate the gain matrix K
-    // Eigen::MatrixXd K = (R + B.transpose() * P * B).inverse() * B.transpose() * P * A;
-    Eigen::MatrixXd K = R.inverse() * B.transpose() * P;
-
-    Eigen::Vector3d Error(error[0], error[1], error[2]);
-    Eigen::Vector3d U = -K * Error;
-
-    // Extract individual control inputs
-    output[0] = U[0];
-    output[1] = U[1];
-    output[2] = U[2];
-
-    // Speed Limiter Only
-    for(int i=0 ; i<=2 ; i++){
-        if(output[i] >= maxSpeed){
-            output[i] = maxSpeed;
-        }
-        else if(output[i] <= -maxSpeed){
-            output[i] = -maxSpeed;
+    {
+        std::lock_guard<std::mutex> lock(StateMutex);
+        Checker.Update(scan_msg->angle_min, scan_msg->angle_increment, scan_msg->ranges.data(), scan_msg->ranges.size(),
+                       scan_msg->range_min, scan_msg->range_max);
+        if (use_grid_check)
+        {
+            Grid.CopyFrom(ScanGrid);
         }
+        scan_time = ros::Time::now();
+        Mark_Input_Stamp(scan_msg->header.stamp);
     }
-
-    robot_vel.x = output[0];
-    robot_vel.y = output[1];
-    robot_vel.theta = output[2];
-
-    // Display the optimal LQR Parameter
-    std::cout << "Optimal control gain matrix K:" << std::endl;
-    std::cout << K << std::endl;
-    std::cout << "error E " << std::endl;
-    std::cout << Error << std::endl;
-    std::cout << "control U " << std::endl;
-    std::cout << U << std::endl;
-    // Display the control inputs
-    std::cout << "Control inputs:" << std::endl;
-    std::cout << "robot_vel.x: " << robot_vel.x << std::endl;
-    std::cout << "robot_vel.y: " << robot_vel.y << std::endl;
-    std::cout << "robot_vel.z: " << robot_vel.theta << std::endl;
-
-    return robot_vel;
-
+    Executor.Notify();
 }
 
-Robot::Pose_t Robot::Global_to_Local_Vel(Pose_t robot_pose, Pose_t global_vel)
+void Robot::Mark_Input_Stamp (const ros::Time &stamp)
 {
-    Pose_t local_vel;
-
-    local_vel.x = global_vel.x * sin(robot_pose.theta) - global_vel.y * cos(robot_pose.theta);
-    local_vel.y = global_vel.x * cos(robot_pose.theta) + global_vel.y * sin(robot_pose.theta);
-    local_vel.theta = global_vel.theta;
-
-    return local_vel;
+    // Unstamped Inputs Count from Their Arrival
+    ros::Time origin = stamp.isZero() ? ros::Time::now() : stamp;
+    if (input_stamp.isZero() || origin < input_stamp)
+    {
+        input_stamp = origin;
+    }
 }
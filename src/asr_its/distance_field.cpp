@@ -0,0 +1,341 @@
+#include "distance_field.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+const float DistanceField::NO_OBSTACLE = 1e6;
+
+// Larger than Any Squared Distance Inside a Map, Small Enough to Add q * q Without Overflow
+static const float FAR_AWAY = 1e20;
+
+static const char     CACHE_MAGIC[8] = {'E', 'D', 'T', 'F', 'I', 'E', 'L', 'D'};
+static const uint32_t CACHE_VERSION  = 1;
+
+struct CacheHeader_t{
+    char        magic[8];
+    uint32_t    version;
+    int32_t     width;
+    int32_t     height;
+    float       resolution;
+    float       origin_x;
+    float       origin_y;
+    uint32_t    reserved;
+    uint64_t    source_hash;
+};
+
+DistanceField::DistanceField(): width(0), height(0), resolution(0.05), origin_x(0.0), origin_y(0.0)
+{
+}
+
+// Squared Distance Transform of One Line, f Sampled at n Points, Lower Envelope of Parabolas
+// Rooted at Each Sample. v Holds Parabola Roots, z the Boundaries Between Them.
+static void Transform1D(const float* f, int n, float* d, int* v, float* z)
+{
+    int k = 0;
+    v[0] = 0;
+    z[0] = -FAR_AWAY;
+    z[1] = FAR_AWAY;
+    for(int q = 1; q < n; q++)
+    {
+        float s = ((f[q] + (float)q * q) - (f[v[k]] + (float)v[k] * v[k])) / (2.0f * (q - v[k]));
+        while(s <= z[k])
+        {
+            k--;
+            s = ((f[q] + (float)q * q) - (f[v[k]] + (float)v[k] * v[k])) / (2.0f * (q - v[k]));
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = FAR_AWAY;
+    }
+
+    k = 0;
+    for(int q = 0; q < n; q++)
+    {
+        while(z[k + 1] < q)
+        {
+            k++;
+        }
+        float dq = (float)(q - v[k]);
+        d[q] = dq * dq + f[v[k]];
+    }
+}
+
+// Run body(first, last) over [0, count) Split into One Contiguous Block per Thread
+template <typename Body>
+static void ParallelBlocks(int count, int threads, Body body)
+{
+    threads = std::max(1, std::min(threads, count));
+    if(threads == 1)
+    {
+        body(0, count);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for(int t = 1; t < threads; t++)
+    {
+        workers.emplace_back(body, (int)((long)count * t / threads), (int)((long)count * (t + 1) / threads));
+    }
+    body(0, (int)(count / threads));
+    for(std::thread &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void DistanceField::Compute(const uint8_t* obstacle, int width, int height, float resolution,
+                            float origin_x, float origin_y, int threads)
+{
+    this->width      = width;
+    this->height     = height;
+    this->resolution = resolution;
+    this->origin_x   = origin_x;
+    this->origin_y   = origin_y;
+    distance.assign((size_t)width * height, 0.0);
+    if(width == 0 || height == 0)
+    {
+        return;
+    }
+
+    if(threads <= 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Columns First, Distance in Cells to the Nearest Obstacle in the Same Column. A binary
+    // input only needs a scan down and one back up, run row by row over a block of columns
+    // so every thread streams through contiguous memory.
+    std::vector<float> &squared = distance;
+    ParallelBlocks(width, threads, [&](int first, int last)
+    {
+        float* row = &squared[first];
+        const uint8_t* cell = &obstacle[first];
+        for(int x = 0; x < last - first; x++)
+        {
+            row[x] = cell[x] ? 0.0f : FAR_AWAY;
+        }
+        for(int y = 1; y < height; y++)
+        {
+            const float* below = row;
+            row += width;
+            cell += width;
+            for(int x = 0; x < last - first; x++)
+            {
+                row[x] = cell[x] ? 0.0f : below[x] + 1.0f;
+            }
+        }
+        for(int y = height - 2; y >= 0; y--)
+        {
+            const float* above = row;
+            row -= width;
+            for(int x = 0; x < last - first; x++)
+            {
+                row[x] = std::min(row[x], above[x] + 1.0f);
+            }
+        }
+        // Squared for the Row Pass, Columns Without Obstacles Stay Far Away
+        for(int y = 0; y < height; y++)
+        {
+            float* out = &squared[(size_t)y * width + first];
+            for(int x = 0; x < last - first; x++)
+            {
+                out[x] = out[x] >= height ? FAR_AWAY : out[x] * out[x];
+            }
+        }
+    });
+
+    // Then Rows over the Column Result, Converted to Meters in Place
+    bool any_obstacle = false;
+    for(size_t i = 0; i < (size_t)width * height && !any_obstacle; i++)
+    {
+        any_obstacle = obstacle[i] != 0;
+    }
+    ParallelBlocks(height, threads, [&](int first, int last)
+    {
+        std::vector<float> d(width), z(width + 1);
+        std::vector<int> v(width);
+        for(int y = first; y < last; y++)
+        {
+            float* row = &squared[(size_t)y * width];
+            Transform1D(row, width, d.data(), v.data(), z.data());
+            for(int x = 0; x < width; x++)
+            {
+                row[x] = any_obstacle ? sqrt(d[x]) * resolution : NO_OBSTACLE;
+            }
+        }
+    });
+}
+
+void DistanceField::Compute(const OccupancyMap &map, bool unknown_is_obstacle, int threads)
+{
+    const std::vector<int8_t> &cells = map.Cells();
+    std::vector<uint8_t> obstacle(cells.size());
+    for(size_t i = 0; i < cells.size(); i++)
+    {
+        obstacle[i] = cells[i] == OccupancyMap::OCCUPIED || (unknown_is_obstacle && cells[i] == OccupancyMap::UNKNOWN);
+    }
+    Compute(obstacle.data(), map.Width(), map.Height(), map.Resolution(), map.OriginX(), map.OriginY(), threads);
+}
+
+uint64_t DistanceField::SourceHash(const OccupancyMap &map, bool unknown_is_obstacle)
+{
+    // FNV-1a over the Geometry and the Cells
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](const void* data, size_t size)
+    {
+        const unsigned char* bytes = (const unsigned char*)data;
+        for(size_t i = 0; i < size; i++)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+
+    int32_t dims[3] = {map.Width(), map.Height(), unknown_is_obstacle};
+    float geometry[3] = {map.Resolution(), map.OriginX(), map.OriginY()};
+    mix(dims, sizeof(dims));
+    mix(geometry, sizeof(geometry));
+    mix(map.Cells().data(), map.Cells().size());
+    return hash;
+}
+
+std::string DistanceField::CachePath(const std::string &yaml_path)
+{
+    size_t dot = yaml_path.rfind('.');
+    size_t slash = yaml_path.rfind('/');
+    if(dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    {
+        return yaml_path + ".edt";
+    }
+    return yaml_path.substr(0, dot) + ".edt";
+}
+
+bool DistanceField::Save(const std::string &cache_path, uint64_t source_hash) const
+{
+    CacheHeader_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version     = CACHE_VERSION;
+    header.width       = width;
+    header.height      = height;
+    header.resolution  = resolution;
+    header.origin_x    = origin_x;
+    header.origin_y    = origin_y;
+    header.source_hash = source_hash;
+
+    // Write Beside and Rename, Readers Never See a Partial File
+    std::string temp_path = cache_path + ".tmp";
+    FILE* file = fopen(temp_path.c_str(), "wb");
+    if(!file)
+    {
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(distance.data(), sizeof(float), distance.size(), file) == distance.size();
+    ok = (fclose(file) == 0) && ok;
+    if(!ok || rename(temp_path.c_str(), cache_path.c_str()) != 0)
+    {
+        remove(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool DistanceField::Load(const std::string &cache_path, uint64_t source_hash)
+{
+    FILE* file = fopen(cache_path.c_str(), "rb");
+    if(!file)
+    {
+        return false;
+    }
+
+    CacheHeader_t header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+              !memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) &&
+              header.version == CACHE_VERSION && header.source_hash == source_hash &&
+              header.width > 0 && header.height > 0;
+    if(ok)
+    {
+        std::vector<float> data((size_t)header.width * header.height);
+        ok = fread(data.data(), sizeof(float), data.size(), file) == data.size();
+        if(ok)
+        {
+            width      = header.width;
+            height     = header.height;
+            resolution = header.resolution;
+            origin_x   = header.origin_x;
+            origin_y   = header.origin_y;
+            distance.swap(data);
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+bool DistanceField::LoadOrCompute(const OccupancyMap &map, const std::string &cache_path,
+                                  bool unknown_is_obstacle, int threads, bool &from_cache)
+{
+    uint64_t hash = SourceHash(map, unknown_is_obstacle);
+    from_cache = !cache_path.empty() && Load(cache_path, hash);
+    if(from_cache)
+    {
+        return true;
+    }
+
+    Compute(map, unknown_is_obstacle, threads);
+    return cache_path.empty() || Save(cache_path, hash);
+}
+
+float DistanceField::Distance(int cx, int cy) const
+{
+    if(cx < 0 || cy < 0 || cx >= width || cy >= height)
+    {
+        return 0.0;
+    }
+    return distance[(size_t)cy * width + cx];
+}
+
+float DistanceField::Clearance(float x, float y) const
+{
+    float fx = (x - origin_x) / resolution;
+    float fy = (y - origin_y) / resolution;
+    if(fx < 0.0 || fy < 0.0 || fx >= width || fy >= height)
+    {
+        return 0.0;
+    }
+    return distance[(size_t)fy * width + (size_t)fx];
+}
+
+int DistanceField::Width() const
+{
+    return width;
+}
+
+int DistanceField::Height() const
+{
+    return height;
+}
+
+float DistanceField::Resolution() const
+{
+    return resolution;
+}
+
+float DistanceField::OriginX() const
+{
+    return origin_x;
+}
+
+float DistanceField::OriginY() const
+{
+    return origin_y;
+}
+
+const std::vector<float>& DistanceField::Data() const
+{
+    return distance;
+}
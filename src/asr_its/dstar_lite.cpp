@@ -0,0 +1,349 @@
+#include "dstar_lite.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static const float INF = std::numeric_limits<float>::infinity();
+static const float TIE_EPSILON = 1e-3f;
+
+DStarLite::DStarLite(): width(0), height(0), active(false), start(-1), last(-1), goal(-1), km(0.0)
+{
+    stats = Stats_t();
+}
+
+void DStarLite::SetMap(const GridPlanner &planner)
+{
+    grid = planner.Grid();
+    width = grid.Width();
+    height = grid.Height();
+
+    g.resize((size_t)width * height);
+    rhs.resize((size_t)width * height);
+    queued.resize((size_t)width * height);
+    in_queue.resize((size_t)width * height);
+    active = false;
+}
+
+bool DStarLite::Free(int cx, int cy) const
+{
+    return grid.Free(cx, cy);
+}
+
+bool DStarLite::Active() const
+{
+    return active;
+}
+
+void DStarLite::Stop()
+{
+    active = false;
+}
+
+int DStarLite::Goal() const
+{
+    return goal;
+}
+
+const DStarLite::Stats_t& DStarLite::Stats() const
+{
+    return stats;
+}
+
+float DStarLite::Heuristic(int a, int b) const
+{
+    return FreeGrid::Octile(a % width - b % width, a / width - b / width);
+}
+
+// Step from a Cell Along (dx, dy), Infinite into a Blocked Cell or Across a Blocked Corner.
+// Symmetric, so predecessors and successors are the same neighbours at the same cost.
+float DStarLite::Cost(int from, int dx, int dy) const
+{
+    int x = from % width, y = from / width;
+    if(!Free(x, y) || !Free(x + dx, y + dy))
+    {
+        return INF;
+    }
+    if(dx && dy)
+    {
+        return (Free(x + dx, y) && Free(x, y + dy)) ? FreeGrid::SQRT2 : INF;
+    }
+    return 1.0;
+}
+
+DStarLite::Key_t DStarLite::CalculateKey(int cell) const
+{
+    float m = std::min(g[cell], rhs[cell]);
+    Key_t key = {m + Heuristic(start, cell) + km, m};
+    return key;
+}
+
+void DStarLite::Push(int cell, const Key_t &key)
+{
+    queued[cell] = key;
+    in_queue[cell] = 1;
+    stats.pushed++;
+    HeapEntry_t entry = {key, cell};
+    heap.push_back(entry);
+    std::push_heap(heap.begin(), heap.end(), FreeGrid::HeapAfter_t());
+}
+
+void DStarLite::UpdateVertex(int cell)
+{
+    // Insert, Update and Remove Are All Lazy, Older Entries Fail the Key Check When Popped
+    if(g[cell] != rhs[cell])
+    {
+        Push(cell, CalculateKey(cell));
+    }
+    else
+    {
+        in_queue[cell] = 0;
+    }
+}
+
+// Lowest Cost Through a Neighbour, and That Neighbour
+float DStarLite::BestSuccessor(int cell, int* next) const
+{
+    float best = INF;
+    int x = cell % width, y = cell / width;
+    for(int d = 0; d < 8; d++)
+    {
+        int dx = FreeGrid::DIRECTION_X[d], dy = FreeGrid::DIRECTION_Y[d];
+        float cost = Cost(cell, dx, dy);
+        if(cost == INF)
+        {
+            continue;
+        }
+        int neighbour = (y + dy) * width + x + dx;
+        float value = cost + g[neighbour];
+        if(value < best)
+        {
+            best = value;
+            if(next)
+            {
+                *next = neighbour;
+            }
+        }
+    }
+    return best;
+}
+
+void DStarLite::ComputeShortestPath()
+{
+    while(!heap.empty())
+    {
+        HeapEntry_t top = heap.front();
+        if(!in_queue[top.cell] || top.key < queued[top.cell] || queued[top.cell] < top.key)
+        {
+            std::pop_heap(heap.begin(), heap.end(), FreeGrid::HeapAfter_t());
+            heap.pop_back();
+            continue;
+        }
+
+        // Ties with the Start Key, up to Rounding, Are Expanded Too, Otherwise a Stale Cell on an
+        // Equally Short Path Can Keep Its Old g and Mislead the Descent to the Goal
+        Key_t start_key = CalculateKey(start);
+        if(top.key.k1 > start_key.k1 + TIE_EPSILON && rhs[start] == g[start])
+        {
+            break;
+        }
+
+        int cell = top.cell;
+        Key_t new_key = CalculateKey(cell);
+        std::pop_heap(heap.begin(), heap.end(), FreeGrid::HeapAfter_t());
+        heap.pop_back();
+        in_queue[cell] = 0;
+        stats.expanded++;
+
+        if(top.key < new_key)
+        {
+            Push(cell, new_key);
+            continue;
+        }
+
+        int x = cell % width, y = cell / width;
+        if(g[cell] > rhs[cell])
+        {
+            g[cell] = rhs[cell];
+            for(int d = 0; d < 8; d++)
+            {
+                int neighbour = (y + FreeGrid::DIRECTION_Y[d]) * width + x + FreeGrid::DIRECTION_X[d];
+                float cost = Cost(cell, FreeGrid::DIRECTION_X[d], FreeGrid::DIRECTION_Y[d]);
+                if(cost == INF || neighbour == goal)
+                {
+                    continue;
+                }
+                if(cost + g[cell] < rhs[neighbour])
+                {
+                    rhs[neighbour] = cost + g[cell];
+                    UpdateVertex(neighbour);
+                }
+            }
+        }
+        else
+        {
+            // Underconsistent, Raise It and Let Every Cell That Relied on It Look Again
+            float g_old = g[cell];
+            g[cell] = INF;
+            for(int d = 0; d <= 8; d++)
+            {
+                int dx = d < 8 ? FreeGrid::DIRECTION_X[d] : 0;
+                int dy = d < 8 ? FreeGrid::DIRECTION_Y[d] : 0;
+                if((unsigned)(x + dx) >= (unsigned)width || (unsigned)(y + dy) >= (unsigned)height)
+                {
+                    continue;
+                }
+                int neighbour = (y + dy) * width + x + dx;
+                if(neighbour == goal)
+                {
+                    continue;
+                }
+                float cost = d < 8 ? Cost(cell, dx, dy) : 0.0f;
+                if(d == 8 || (cost != INF && rhs[neighbour] == cost + g_old))
+                {
+                    rhs[neighbour] = BestSuccessor(neighbour, NULL);
+                }
+                UpdateVertex(neighbour);
+            }
+        }
+    }
+}
+
+bool DStarLite::Start(int start, int goal)
+{
+    active = false;
+    heap.clear();
+    if(start < 0 || goal < 0 || start >= width * height || goal >= width * height ||
+       !Free(start % width, start / width) || !Free(goal % width, goal / width))
+    {
+        return false;
+    }
+
+    std::fill(g.begin(), g.end(), INF);
+    std::fill(rhs.begin(), rhs.end(), INF);
+    std::fill(in_queue.begin(), in_queue.end(), 0);
+    this->start = start;
+    this->last = start;
+    this->goal = goal;
+    km = 0.0;
+    stats = Stats_t();
+
+    rhs[goal] = 0.0;
+    Push(goal, CalculateKey(goal));
+    ComputeShortestPath();
+    active = true;
+    return g[start] != INF;
+}
+
+void DStarLite::Block(int cx, int cy)
+{
+    if(!Free(cx, cy))
+    {
+        return;
+    }
+    grid.Block(cx, cy);
+    stats.changed++;
+
+    // Edges Touching the Cell and Diagonals Around Its Corner All Belong to It or Its Neighbours
+    for(int dy = -1; dy <= 1; dy++)
+    {
+        for(int dx = -1; dx <= 1; dx++)
+        {
+            if((unsigned)(cx + dx) < (unsigned)width && (unsigned)(cy + dy) < (unsigned)height)
+            {
+                dirty.push_back((cy + dy) * width + cx + dx);
+            }
+        }
+    }
+}
+
+bool DStarLite::AddObstacles(const std::vector<GridPlanner::Point_t> &points, float radius)
+{
+    stats.changed = 0;
+    stats.pushed = 0;
+    dirty.clear();
+
+    // Same Rule as the Static Inflation, Cell Centres Closer than Radius Plus Half a Cell
+    float resolution = grid.Resolution();
+    float reach = radius + 0.5 * resolution;
+    int cells = (int)ceil(reach / resolution);
+    for(const GridPlanner::Point_t &point : points)
+    {
+        int px = (int)floor((point.x - grid.OriginX()) / resolution);
+        int py = (int)floor((point.y - grid.OriginY()) / resolution);
+        for(int dy = -cells; dy <= cells; dy++)
+        {
+            for(int dx = -cells; dx <= cells; dx++)
+            {
+                if((dx * dx + dy * dy) * resolution * resolution < reach * reach)
+                {
+                    Block(px + dx, py + dy);
+                }
+            }
+        }
+    }
+
+    if(!active || dirty.empty())
+    {
+        return stats.changed > 0;
+    }
+
+    // Changed Edge Costs Only Touch the rhs of the Cells Around the Blocked Ones
+    std::sort(dirty.begin(), dirty.end());
+    dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+    for(int cell : dirty)
+    {
+        if(cell != goal)
+        {
+            rhs[cell] = BestSuccessor(cell, NULL);
+        }
+        UpdateVertex(cell);
+    }
+    return stats.changed > 0;
+}
+
+bool DStarLite::Replan(int start, std::vector<int> &cells)
+{
+    cells.clear();
+    stats.expanded = 0;
+    if(!active || start < 0 || start >= width * height)
+    {
+        return false;
+    }
+
+    // New Obstacles Can Inflate over the Robot, Leave from the Nearest Free Cell
+    if(!Free(start % width, start / width))
+    {
+        start = grid.NearestFree(start % width, start / width, (int)ceil(0.5 / grid.Resolution()));
+        if(start < 0)
+        {
+            return false;
+        }
+    }
+
+    // Keys Already Queued Stay Valid Lower Bounds After the Start Moves by Adding km
+    km += Heuristic(last, start);
+    last = start;
+    this->start = start;
+    ComputeShortestPath();
+    if(g[start] == INF)
+    {
+        return false;
+    }
+
+    // Follow the Cheapest Successor Down to the Goal
+    int cell = start;
+    cells.push_back(cell);
+    while(cell != goal)
+    {
+        int next = -1;
+        if(BestSuccessor(cell, &next) == INF || (int)cells.size() >= width * height)
+        {
+            cells.clear();
+            return false;
+        }
+        cell = next;
+        cells.push_back(cell);
+    }
+    return true;
+}
@@ -0,0 +1,135 @@
+#include "free_grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+const float FreeGrid::SQRT2 = 1.41421356f;
+
+const int FreeGrid::DIRECTION_X[8] = {1, 0, -1, 0, 1, -1, -1, 1};
+const int FreeGrid::DIRECTION_Y[8] = {0, 1, 0, -1, 1, 1, -1, -1};
+
+FreeGrid::FreeGrid(): width(0), height(0), words(0), resolution(0.05), origin_x(0.0), origin_y(0.0)
+{
+}
+
+void FreeGrid::Build(const float* distance, int width, int height, float resolution,
+                     float origin_x, float origin_y, float inflation_radius)
+{
+    this->width      = width;
+    this->height     = height;
+    this->words      = (width + 63) / 64;
+    this->resolution = resolution;
+    this->origin_x   = origin_x;
+    this->origin_y   = origin_y;
+
+    // Distances Are Between Cell Centres, Half a Cell More Reaches the Edge of the Obstacle Cell
+    float threshold = inflation_radius + 0.5 * resolution;
+    bits.assign((size_t)words * height, 0);
+    for(int y = 0; y < height; y++)
+    {
+        const float* row = &distance[(size_t)y * width];
+        uint64_t* row_bits = &bits[(size_t)y * words];
+        for(int x = 0; x < width; x++)
+        {
+            if(row[x] >= threshold)
+            {
+                row_bits[x >> 6] |= 1ULL << (x & 63);
+            }
+        }
+    }
+}
+
+bool FreeGrid::Empty() const
+{
+    return bits.empty();
+}
+
+void FreeGrid::Block(int cx, int cy)
+{
+    if((unsigned)cx < (unsigned)width && (unsigned)cy < (unsigned)height)
+    {
+        bits[(size_t)cy * words + (cx >> 6)] &= ~(1ULL << (cx & 63));
+    }
+}
+
+bool FreeGrid::WorldToCell(float x, float y, int &cx, int &cy) const
+{
+    float fx = (x - origin_x) / resolution;
+    float fy = (y - origin_y) / resolution;
+    if(fx < 0.0 || fy < 0.0 || fx >= width || fy >= height)
+    {
+        return false;
+    }
+    cx = (int)fx;
+    cy = (int)fy;
+    return true;
+}
+
+FreeGrid::Point_t FreeGrid::CellCenter(int cell) const
+{
+    Point_t point;
+    point.x = origin_x + (cell % width + 0.5) * resolution;
+    point.y = origin_y + (cell / width + 0.5) * resolution;
+    return point;
+}
+
+int FreeGrid::NearestFree(int cx, int cy, int max_ring) const
+{
+    int best = -1;
+    int best_d2 = 0;
+    for(int ring = 0; ring <= max_ring; ring++)
+    {
+        // A Later Ring Cannot Beat a Cell Closer than Its Inner Edge
+        if(best >= 0 && best_d2 <= ring * ring)
+        {
+            break;
+        }
+        for(int dy = -ring; dy <= ring; dy++)
+        {
+            int step = (dy == -ring || dy == ring) ? 1 : 2 * ring;
+            for(int dx = -ring; dx <= ring; dx += std::max(step, 1))
+            {
+                int d2 = dx * dx + dy * dy;
+                if(Free(cx + dx, cy + dy) && (best < 0 || d2 < best_d2) && d2 <= max_ring * max_ring)
+                {
+                    best = (cy + dy) * width + cx + dx;
+                    best_d2 = d2;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+float FreeGrid::Octile(int dx, int dy)
+{
+    dx = abs(dx);
+    dy = abs(dy);
+    return (dx + dy) + (SQRT2 - 2.0f) * std::min(dx, dy);
+}
+
+int FreeGrid::Width() const
+{
+    return width;
+}
+
+int FreeGrid::Height() const
+{
+    return height;
+}
+
+float FreeGrid::Resolution() const
+{
+    return resolution;
+}
+
+float FreeGrid::OriginX() const
+{
+    return origin_x;
+}
+
+float FreeGrid::OriginY() const
+{
+    return origin_y;
+}
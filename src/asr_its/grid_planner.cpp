@@ -0,0 +1,438 @@
+#include "grid_planner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+GridPlanner::GridPlanner(): width(0), height(0), generation(0)
+{
+    config.algorithm        = JPS;
+    config.inflation_radius = 0.3;
+    config.snap_distance    = 0.5;
+    stats = Stats_t();
+}
+
+void GridPlanner::Configure(const Config_t &config)
+{
+    bool reinflate = config.inflation_radius != this->config.inflation_radius;
+    this->config = config;
+    if(reinflate && !distance.empty())
+    {
+        BuildGrid();
+    }
+}
+
+const GridPlanner::Config_t& GridPlanner::Config() const
+{
+    return config;
+}
+
+bool GridPlanner::ParseAlgorithm(const std::string &name, Algorithm_t &algorithm)
+{
+    if(name == "astar")
+    {
+        algorithm = ASTAR;
+    }
+    else if(name == "jps")
+    {
+        algorithm = JPS;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+const char* GridPlanner::AlgorithmName(Algorithm_t algorithm)
+{
+    return algorithm == ASTAR ? "astar" : "jps";
+}
+
+void GridPlanner::SetMap(const float* distance, int width, int height, float resolution,
+                         float origin_x, float origin_y)
+{
+    this->distance.assign(distance, distance + (size_t)width * height);
+    grid.Build(distance, width, height, resolution, origin_x, origin_y, config.inflation_radius);
+    this->width  = width;
+    this->height = height;
+
+    // Arena Sized Once per Map, Every Query Reuses It
+    generation = 0;
+    state.assign((size_t)width * height, 0);
+    g.resize((size_t)width * height);
+    parent.resize((size_t)width * height);
+    heap.reserve(4096);
+}
+
+void GridPlanner::SetMap(const DistanceField &field)
+{
+    SetMap(field.Data().data(), field.Width(), field.Height(), field.Resolution(), field.OriginX(), field.OriginY());
+}
+
+void GridPlanner::SetMap(const MapFile &file)
+{
+    SetMap(file.Distance(), file.Width(), file.Height(), file.Resolution(), file.OriginX(), file.OriginY());
+}
+
+void GridPlanner::BuildGrid()
+{
+    grid.Build(distance.data(), grid.Width(), grid.Height(), grid.Resolution(), grid.OriginX(), grid.OriginY(),
+               config.inflation_radius);
+}
+
+bool GridPlanner::Free(int cx, int cy) const
+{
+    return grid.Free(cx, cy);
+}
+
+bool GridPlanner::WorldToCell(float x, float y, int &cx, int &cy) const
+{
+    return grid.WorldToCell(x, y, cx, cy);
+}
+
+GridPlanner::Point_t GridPlanner::CellCenter(int cell) const
+{
+    return grid.CellCenter(cell);
+}
+
+int GridPlanner::Width() const
+{
+    return width;
+}
+
+int GridPlanner::Height() const
+{
+    return height;
+}
+
+float GridPlanner::Resolution() const
+{
+    return grid.Resolution();
+}
+
+const FreeGrid& GridPlanner::Grid() const
+{
+    return grid;
+}
+
+const GridPlanner::Stats_t& GridPlanner::Stats() const
+{
+    return stats;
+}
+
+void GridPlanner::NewQuery()
+{
+    heap.clear();
+    stats = Stats_t();
+    if(++generation >= 0x7FFFFFFF)
+    {
+        std::fill(state.begin(), state.end(), 0);
+        generation = 1;
+    }
+}
+
+bool GridPlanner::Open(int cell, float cost, int from, float h)
+{
+    uint32_t s = state[cell];
+    if((s >> 1) == generation && ((s & 1) || cost >= g[cell]))
+    {
+        return false;
+    }
+    state[cell] = generation << 1;
+    g[cell] = cost;
+    parent[cell] = from;
+
+    HeapEntry_t entry = {cost + h, cell};
+    heap.push_back(entry);
+    std::push_heap(heap.begin(), heap.end(), FreeGrid::HeapAfter_t());
+    stats.pushed++;
+    return true;
+}
+
+bool GridPlanner::SearchAStar(int start, int goal)
+{
+    int gx = goal % width, gy = goal / width;
+
+    Open(start, 0.0, -1, FreeGrid::Octile(start % width - gx, start / width - gy));
+    while(!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end(), FreeGrid::HeapAfter_t());
+        int cell = heap.back().cell;
+        heap.pop_back();
+
+        // Entries Left Behind by a Cheaper Reopen Are Skipped
+        if(state[cell] & 1)
+        {
+            continue;
+        }
+        state[cell] |= 1;
+        stats.expanded++;
+        if(cell == goal)
+        {
+            return true;
+        }
+
+        int x = cell % width, y = cell / width;
+        for(int d = 0; d < 8; d++)
+        {
+            int dx = FreeGrid::DIRECTION_X[d], dy = FreeGrid::DIRECTION_Y[d];
+            if(!Free(x + dx, y + dy) || (dx && dy && (!Free(x + dx, y) || !Free(x, y + dy))))
+            {
+                continue;
+            }
+            int next = cell + dy * width + dx;
+            float step = (dx && dy) ? FreeGrid::SQRT2 : 1.0f;
+            Open(next, g[cell] + step, cell, FreeGrid::Octile(x + dx - gx, y + dy - gy));
+        }
+    }
+    return false;
+}
+
+// First Jump Point Reached from (x, y) Moving Along (dx, dy), -1 When the Run Ends at a Wall.
+// Diagonal moves never cut corners, so a straight run has a forced neighbour where a wall
+// beside it ends and a diagonal run stops where one of its straight runs finds a point.
+int GridPlanner::Jump(int x, int y, int dx, int dy, int gx, int gy) const
+{
+    while(true)
+    {
+        if(!Free(x, y))
+        {
+            return -1;
+        }
+        if(x == gx && y == gy)
+        {
+            return y * width + x;
+        }
+
+        if(dx && dy)
+        {
+            if(Jump(x + dx, y, dx, 0, gx, gy) >= 0 || Jump(x, y + dy, 0, dy, gx, gy) >= 0)
+            {
+                return y * width + x;
+            }
+            if(!Free(x + dx, y) || !Free(x, y + dy))
+            {
+                return -1;
+            }
+        }
+        else if(dx)
+        {
+            if((Free(x, y - 1) && !Free(x - dx, y - 1)) || (Free(x, y + 1) && !Free(x - dx, y + 1)))
+            {
+                return y * width + x;
+            }
+        }
+        else
+        {
+            if((Free(x - 1, y) && !Free(x - 1, y - dy)) || (Free(x + 1, y) && !Free(x + 1, y - dy)))
+            {
+                return y * width + x;
+            }
+        }
+        x += dx;
+        y += dy;
+    }
+}
+
+bool GridPlanner::SearchJPS(int start, int goal)
+{
+    int gx = goal % width, gy = goal / width;
+
+    Open(start, 0.0, -1, FreeGrid::Octile(start % width - gx, start / width - gy));
+    while(!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end(), FreeGrid::HeapAfter_t());
+        int cell = heap.back().cell;
+        heap.pop_back();
+
+        if(state[cell] & 1)
+        {
+            continue;
+        }
+        state[cell] |= 1;
+        stats.expanded++;
+        if(cell == goal)
+        {
+            return true;
+        }
+
+        // Pruned Neighbour Directions from the Direction of Arrival
+        int x = cell % width, y = cell / width;
+        int directions[8][2];
+        int count = 0;
+        if(parent[cell] < 0)
+        {
+            for(int d = 0; d < 8; d++)
+            {
+                int dx = FreeGrid::DIRECTION_X[d], dy = FreeGrid::DIRECTION_Y[d];
+                if(!(dx && dy) || (Free(x + dx, y) && Free(x, y + dy)))
+                {
+                    directions[count][0] = dx;
+                    directions[count][1] = dy;
+                    count++;
+                }
+            }
+        }
+        else
+        {
+            int px = parent[cell] % width, py = parent[cell] / width;
+            int dx = (x > px) - (x < px);
+            int dy = (y > py) - (y < py);
+            if(dx && dy)
+            {
+                bool vertical = Free(x, y + dy);
+                bool horizontal = Free(x + dx, y);
+                if(vertical)
+                {
+                    directions[count][0] = 0;  directions[count][1] = dy; count++;
+                }
+                if(horizontal)
+                {
+                    directions[count][0] = dx; directions[count][1] = 0;  count++;
+                }
+                if(vertical && horizontal)
+                {
+                    directions[count][0] = dx; directions[count][1] = dy; count++;
+                }
+            }
+            else
+            {
+                // Perpendicular Axis of the Straight Move
+                int sx = dy ? 1 : 0, sy = dx ? 1 : 0;
+                bool next = Free(x + dx, y + dy);
+                bool side_a = Free(x + sx, y + sy);
+                bool side_b = Free(x - sx, y - sy);
+                if(next)
+                {
+                    directions[count][0] = dx; directions[count][1] = dy; count++;
+                    if(side_a)
+                    {
+                        directions[count][0] = dx + sx; directions[count][1] = dy + sy; count++;
+                    }
+                    if(side_b)
+                    {
+                        directions[count][0] = dx - sx; directions[count][1] = dy - sy; count++;
+                    }
+                }
+                if(side_a)
+                {
+                    directions[count][0] = sx;  directions[count][1] = sy;  count++;
+                }
+                if(side_b)
+                {
+                    directions[count][0] = -sx; directions[count][1] = -sy; count++;
+                }
+            }
+        }
+
+        for(int i = 0; i < count; i++)
+        {
+            int dx = directions[i][0], dy = directions[i][1];
+            int point = Jump(x + dx, y + dy, dx, dy, gx, gy);
+            if(point < 0)
+            {
+                continue;
+            }
+            int px = point % width, py = point / width;
+            Open(point, g[cell] + FreeGrid::Octile(x - px, y - py), cell, FreeGrid::Octile(px - gx, py - gy));
+        }
+    }
+    return false;
+}
+
+bool GridPlanner::PlanCells(int start, int goal, std::vector<int> &cells)
+{
+    cells.clear();
+    NewQuery();
+    if(start < 0 || goal < 0 || start >= width * height || goal >= width * height)
+    {
+        return false;
+    }
+    if(!Free(start % width, start / width) || !Free(goal % width, goal / width))
+    {
+        return false;
+    }
+
+    bool found = config.algorithm == JPS ? SearchJPS(start, goal) : SearchAStar(start, goal);
+    if(!found)
+    {
+        return false;
+    }
+
+    // Walk Back, Filling the Straight and Diagonal Runs Between Jump Points Cell by Cell
+    for(int cell = goal; cell >= 0; cell = parent[cell])
+    {
+        cells.push_back(cell);
+        int from = parent[cell];
+        if(from < 0)
+        {
+            break;
+        }
+        int x = cell % width, y = cell / width;
+        int fx = from % width, fy = from / width;
+        int dx = (fx > x) - (fx < x);
+        int dy = (fy > y) - (fy < y);
+        for(x += dx, y += dy; x != fx || y != fy; x += dx, y += dy)
+        {
+            cells.push_back(y * width + x);
+        }
+    }
+    std::reverse(cells.begin(), cells.end());
+    return true;
+}
+
+bool GridPlanner::Plan(float start_x, float start_y, float goal_x, float goal_y, std::vector<Point_t> &path)
+{
+    path.clear();
+    int sx, sy, gx, gy;
+    if(!WorldToCell(start_x, start_y, sx, sy) || !WorldToCell(goal_x, goal_y, gx, gy))
+    {
+        stats = Stats_t();
+        return false;
+    }
+
+    // Robot Inside the Inflation, or a Goal Next to a Wall, Moves to the Nearest Free Cell
+    int snap = (int)(config.snap_distance / grid.Resolution());
+    int start = Free(sx, sy) ? sy * width + sx : grid.NearestFree(sx, sy, snap);
+    int goal = Free(gx, gy) ? gy * width + gx : grid.NearestFree(gx, gy, snap);
+    bool start_snapped = start != sy * width + sx;
+    bool goal_snapped = goal != gy * width + gx;
+
+    if(!PlanCells(start, goal, cell_path))
+    {
+        stats.start_snapped = start_snapped;
+        stats.goal_snapped = goal_snapped;
+        return false;
+    }
+    stats.start_snapped = start_snapped;
+    stats.goal_snapped = goal_snapped;
+
+    // Cell Centres, with the Exact Start and Goal Where They Are Free
+    path.reserve(cell_path.size() + 1);
+    if(start_snapped)
+    {
+        Point_t robot = {start_x, start_y};
+        path.push_back(robot);
+    }
+    for(int cell : cell_path)
+    {
+        path.push_back(CellCenter(cell));
+    }
+    if(!start_snapped)
+    {
+        path.front().x = start_x;
+        path.front().y = start_y;
+    }
+    if(!goal_snapped)
+    {
+        path.back().x = goal_x;
+        path.back().y = goal_y;
+    }
+
+    for(size_t i = 1; i < path.size(); i++)
+    {
+        stats.length += hypot(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y);
+    }
+    return true;
+}
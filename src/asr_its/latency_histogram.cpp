@@ -0,0 +1,62 @@
+#include "latency_histogram.h"
+
+#include <algorithm>
+
+const float LatencyHistogram::FIRST_EDGE = 50.0;
+
+LatencyHistogram::LatencyHistogram()
+{
+    Reset();
+}
+
+void LatencyHistogram::Reset()
+{
+    for(int i = 0; i < BINS; i++)
+    {
+        counts[i] = 0;
+    }
+    samples = 0;
+    sum = 0.0;
+    max = 0.0;
+}
+
+float LatencyHistogram::BinEdge(int bin)
+{
+    return FIRST_EDGE * (float)(1 << bin);
+}
+
+void LatencyHistogram::Add(double latency)
+{
+    double us = std::max(latency, 0.0) * 1e6;
+
+    int bin = 0;
+    while(bin < BINS - 1 && us > BinEdge(bin))
+    {
+        bin++;
+    }
+
+    counts[bin]++;
+    samples++;
+    sum += us;
+    max = std::max(max, us);
+}
+
+uint32_t LatencyHistogram::Count(int bin) const
+{
+    return counts[bin];
+}
+
+uint64_t LatencyHistogram::Samples() const
+{
+    return samples;
+}
+
+float LatencyHistogram::Mean() const
+{
+    return samples ? sum / samples : 0.0;
+}
+
+float LatencyHistogram::Max() const
+{
+    return max;
+}
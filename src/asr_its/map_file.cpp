@@ -0,0 +1,331 @@
+#include "map_file.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char     MAP_MAGIC[8] = {'A', 'S', 'R', 'B', 'M', 'A', 'P', 0};
+static const uint32_t MAP_VERSION  = 1;
+static const uint64_t SECTION_ALIGN = 64;
+
+static uint64_t Align(uint64_t offset)
+{
+    return (offset + SECTION_ALIGN - 1) & ~(SECTION_ALIGN - 1);
+}
+
+MapFile::MapFile(): data(NULL), size(0), header(NULL)
+{
+}
+
+MapFile::~MapFile()
+{
+    Close();
+}
+
+std::string MapFile::PathFor(const std::string &yaml_path)
+{
+    std::string path = DistanceField::CachePath(yaml_path);
+    return path.substr(0, path.size() - 4) + ".bmap";
+}
+
+bool MapFile::Write(const std::string &path, const OccupancyMap &map, const DistanceField &field,
+                    bool unknown_is_obstacle, std::string &error)
+{
+    int width = map.Width();
+    int height = map.Height();
+    if(width <= 0 || height <= 0 || field.Width() != width || field.Height() != height)
+    {
+        error = "distance field does not match the map";
+        return false;
+    }
+
+    // Section Layout
+    Header_t head;
+    memset(&head, 0, sizeof(head));
+    memcpy(head.magic, MAP_MAGIC, sizeof(head.magic));
+    head.version             = MAP_VERSION;
+    head.header_size         = sizeof(Header_t);
+    head.width               = width;
+    head.height              = height;
+    head.resolution          = map.Resolution();
+    head.origin_x            = map.OriginX();
+    head.origin_y            = map.OriginY();
+    head.unknown_is_obstacle = unknown_is_obstacle;
+    head.words_per_row       = (width + 63) / 64;
+    head.source_hash         = DistanceField::SourceHash(map, unknown_is_obstacle);
+
+    uint64_t offset = Align(sizeof(Header_t));
+    head.cells_offset = offset;
+    offset = Align(offset + (uint64_t)width * height);
+    head.bits_offset = offset;
+    offset = Align(offset + (uint64_t)head.words_per_row * height * sizeof(uint64_t));
+    head.distance_offset = offset;
+    offset = Align(offset + (uint64_t)width * height * sizeof(float));
+
+    // Halve Until One Cell Remains
+    int level_width = width;
+    int level_height = height;
+    while(head.levels < (uint32_t)MAX_LEVELS)
+    {
+        Level_t &level = head.level[head.levels++];
+        level.width  = level_width;
+        level.height = level_height;
+        level.offset = offset;
+        offset = Align(offset + (uint64_t)level_width * level_height);
+        if(level_width == 1 && level_height == 1)
+        {
+            break;
+        }
+        level_width  = (level_width + 1) / 2;
+        level_height = (level_height + 1) / 2;
+    }
+    head.file_size = offset;
+
+    std::vector<unsigned char> buffer(head.file_size, 0);
+    memcpy(buffer.data(), &head, sizeof(head));
+
+    const std::vector<int8_t> &cells = map.Cells();
+    memcpy(&buffer[head.cells_offset], cells.data(), cells.size());
+
+    uint64_t* bits = (uint64_t*)&buffer[head.bits_offset];
+    uint8_t* base = &buffer[head.level[0].offset];
+    for(int y = 0; y < height; y++)
+    {
+        for(int x = 0; x < width; x++)
+        {
+            int8_t cell = cells[(size_t)y * width + x];
+            bool obstacle = cell == OccupancyMap::OCCUPIED || (unknown_is_obstacle && cell == OccupancyMap::UNKNOWN);
+            if(obstacle)
+            {
+                bits[(size_t)y * head.words_per_row + (x >> 6)] |= 1ULL << (x & 63);
+            }
+            base[(size_t)y * width + x] = obstacle;
+        }
+    }
+
+    memcpy(&buffer[head.distance_offset], field.Data().data(), field.Data().size() * sizeof(float));
+
+    // Each Coarser Cell Is the Max of Its 2 x 2 Children, Missing Children at the Edge Ignored
+    for(uint32_t l = 1; l < head.levels; l++)
+    {
+        const Level_t &fine = head.level[l - 1];
+        const Level_t &coarse = head.level[l];
+        const uint8_t* in = &buffer[fine.offset];
+        uint8_t* out = &buffer[coarse.offset];
+        for(int y = 0; y < coarse.height; y++)
+        {
+            for(int x = 0; x < coarse.width; x++)
+            {
+                int x0 = 2 * x, y0 = 2 * y;
+                int x1 = std::min(x0 + 1, fine.width - 1), y1 = std::min(y0 + 1, fine.height - 1);
+                out[(size_t)y * coarse.width + x] = std::max(std::max(in[(size_t)y0 * fine.width + x0], in[(size_t)y0 * fine.width + x1]),
+                                                             std::max(in[(size_t)y1 * fine.width + x0], in[(size_t)y1 * fine.width + x1]));
+            }
+        }
+    }
+
+    // Write Beside and Rename, Processes Mapping the Old File Keep Their Pages
+    std::string temp_path = path + ".tmp";
+    FILE* file = fopen(temp_path.c_str(), "wb");
+    if(!file)
+    {
+        error = "cannot create " + temp_path;
+        return false;
+    }
+    bool ok = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    ok = (fclose(file) == 0) && ok;
+    if(!ok || rename(temp_path.c_str(), path.c_str()) != 0)
+    {
+        remove(temp_path.c_str());
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+bool MapFile::Open(const std::string &path, std::string &error)
+{
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(Header_t))
+    {
+        close(fd);
+        error = path + " is not a map file";
+        return false;
+    }
+
+    void* mapped = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(mapped == MAP_FAILED)
+    {
+        error = "cannot map " + path;
+        return false;
+    }
+    data = (const unsigned char*)mapped;
+    size = info.st_size;
+    header = (const Header_t*)data;
+
+    // Every Section Must Lie Inside the File Before Anything Is Read from It
+    bool ok = !memcmp(header->magic, MAP_MAGIC, sizeof(header->magic)) && header->version == MAP_VERSION &&
+              header->header_size == sizeof(Header_t) && header->file_size == size &&
+              header->width > 0 && header->height > 0 && header->levels > 0 && header->levels <= (uint32_t)MAX_LEVELS &&
+              header->words_per_row == (uint32_t)(header->width + 63) / 64;
+    uint64_t cells = (uint64_t)header->width * header->height;
+    ok = ok && header->cells_offset + cells <= size &&
+         header->bits_offset + (uint64_t)header->words_per_row * header->height * sizeof(uint64_t) <= size &&
+         header->distance_offset + cells * sizeof(float) <= size &&
+         header->bits_offset % sizeof(uint64_t) == 0 && header->distance_offset % sizeof(float) == 0;
+    for(uint32_t l = 0; ok && l < header->levels; l++)
+    {
+        const Level_t &level = header->level[l];
+        ok = level.width > 0 && level.height > 0 && level.offset + (uint64_t)level.width * level.height <= size;
+    }
+    if(!ok)
+    {
+        Close();
+        error = path + " is not a valid map file (version " + std::to_string(MAP_VERSION) + " expected)";
+        return false;
+    }
+    return true;
+}
+
+void MapFile::Close()
+{
+    if(data)
+    {
+        munmap((void*)data, size);
+    }
+    data = NULL;
+    size = 0;
+    header = NULL;
+}
+
+bool MapFile::IsOpen() const
+{
+    return header != NULL;
+}
+
+int MapFile::Width() const
+{
+    return header->width;
+}
+
+int MapFile::Height() const
+{
+    return header->height;
+}
+
+float MapFile::Resolution() const
+{
+    return header->resolution;
+}
+
+float MapFile::OriginX() const
+{
+    return header->origin_x;
+}
+
+float MapFile::OriginY() const
+{
+    return header->origin_y;
+}
+
+const MapFile::Header_t& MapFile::Header() const
+{
+    return *header;
+}
+
+bool MapFile::WorldToCell(float x, float y, int &cx, int &cy) const
+{
+    float fx = (x - header->origin_x) / header->resolution;
+    float fy = (y - header->origin_y) / header->resolution;
+    if(fx < 0.0 || fy < 0.0 || fx >= header->width || fy >= header->height)
+    {
+        return false;
+    }
+    cx = (int)fx;
+    cy = (int)fy;
+    return true;
+}
+
+const int8_t* MapFile::Cells() const
+{
+    return (const int8_t*)(data + header->cells_offset);
+}
+
+const uint64_t* MapFile::Bits() const
+{
+    return (const uint64_t*)(data + header->bits_offset);
+}
+
+int MapFile::WordsPerRow() const
+{
+    return header->words_per_row;
+}
+
+bool MapFile::Occupied(int cx, int cy) const
+{
+    if(cx < 0 || cy < 0 || cx >= header->width || cy >= header->height)
+    {
+        return true;
+    }
+    return (Bits()[(size_t)cy * header->words_per_row + (cx >> 6)] >> (cx & 63)) & 1;
+}
+
+const float* MapFile::Distance() const
+{
+    return (const float*)(data + header->distance_offset);
+}
+
+float MapFile::Clearance(float x, float y) const
+{
+    int cx, cy;
+    if(!WorldToCell(x, y, cx, cy))
+    {
+        return 0.0;
+    }
+    return Distance()[(size_t)cy * header->width + cx];
+}
+
+int MapFile::Levels() const
+{
+    return header->levels;
+}
+
+int MapFile::LevelWidth(int level) const
+{
+    return header->level[level].width;
+}
+
+int MapFile::LevelHeight(int level) const
+{
+    return header->level[level].height;
+}
+
+const uint8_t* MapFile::Level(int level) const
+{
+    return data + header->level[level].offset;
+}
+
+bool MapFile::BlockOccupied(int level, int cx, int cy) const
+{
+    if(cx < 0 || cy < 0 || cx >= header->width || cy >= header->height)
+    {
+        return true;
+    }
+    const Level_t &l = header->level[level];
+    return Level(level)[(size_t)(cy >> level) * l.width + (cx >> level)] != 0;
+}
@@ -0,0 +1,182 @@
+#include "mpc_controller.h"
+
+#include <algorithm>
+#include <cmath>
+
+static float WrapAngle(float angle)
+{
+    return atan2(sin(angle), cos(angle));
+}
+
+MpcController::MpcController()
+{
+    Config_t config;
+    config.dt                = 0.1;
+    config.q_position        = 2000.0;
+    config.q_theta           = 200.0;
+    config.r_speed           = 0.01;
+    config.r_accel           = 0.05;
+    config.max_speed         = 30.0;
+    config.max_angular       = 30.0;
+    config.max_accel         = 60.0;
+    config.max_angular_accel = 60.0;
+    config.angular_scale     = 57.29578;
+    config.rho               = 0.1;
+    config.max_iterations    = 40;
+    Configure(config);
+}
+
+void MpcController::Configure(const Config_t &config)
+{
+    Config = config;
+
+    // Constraint Rows: Command Bounds Then Command Change Bounds
+    Matrix_t D = Matrix_t::Identity();
+    for(int k = 1; k < HORIZON; k++)
+    {
+        D(k, k-1) = -1.0;
+    }
+    A.topRows<HORIZON>()    = Matrix_t::Identity();
+    A.bottomRows<HORIZON>() = D;
+
+    Prepare(Axis[0], Config.q_position, Config.dt / 100.0, Config.max_speed, Config.max_accel);
+    Prepare(Axis[1], Config.q_position, Config.dt / 100.0, Config.max_speed, Config.max_accel);
+    Prepare(Axis[2], Config.q_theta, Config.dt / Config.angular_scale, Config.max_angular, Config.max_angular_accel);
+
+    Reset();
+}
+
+void MpcController::Reset()
+{
+    for(int i = 0; i < 3; i++)
+    {
+        Axis[i].x.setZero();
+        Axis[i].z.setZero();
+        Axis[i].y.setZero();
+        Axis[i].prev_command = 0.0;
+    }
+    LastIterations = 0;
+}
+
+MpcController::Pose_t MpcController::Compute(const Pose_t &robot_pose, const Pose_t reference[HORIZON], float tick_dt)
+{
+    Vector_t ref_x, ref_y, ref_theta;
+    for(int k = 0; k < HORIZON; k++)
+    {
+        ref_x[k] = reference[k].x;
+        ref_y[k] = reference[k].y;
+
+        // Unwrap Heading Reference Around Current Heading
+        ref_theta[k] = robot_pose.theta + WrapAngle(reference[k].theta - robot_pose.theta);
+    }
+
+    LastIterations = 0;
+
+    Pose_t command;
+    command.x     = Solve(Axis[0], robot_pose.x, ref_x, tick_dt);
+    command.y     = Solve(Axis[1], robot_pose.y, ref_y, tick_dt);
+    command.theta = Solve(Axis[2], robot_pose.theta, ref_theta, tick_dt);
+    return command;
+}
+
+void MpcController::SetMaxSpeed(float max_speed)
+{
+    if(max_speed <= 0.0)
+    {
+        max_speed = Config.max_speed;
+    }
+    Axis[0].max_speed = max_speed;
+    Axis[1].max_speed = max_speed;
+}
+
+int MpcController::Iterations() const
+{
+    return LastIterations;
+}
+
+void MpcController::Prepare(Axis_t &axis, float q, float gain, float max_speed, float max_accel)
+{
+    // Position After k + 1 Steps Is position + gain * (sum of first k + 1 commands)
+    Matrix_t L = Matrix_t::Zero();
+    for(int k = 0; k < HORIZON; k++)
+    {
+        for(int j = 0; j <= k; j++)
+        {
+            L(k, j) = 1.0;
+        }
+    }
+    Matrix_t D = A.bottomRows<HORIZON>();
+
+    axis.q         = q;
+    axis.gain      = gain;
+    axis.max_speed = max_speed;
+    axis.max_accel = max_accel;
+    axis.F = -2.0 * q * gain * L.transpose();
+    axis.H = 2.0 * (q * gain * gain * L.transpose() * L
+                    + Config.r_speed * Matrix_t::Identity()
+                    + Config.r_accel * D.transpose() * D);
+
+    // ADMM Linear System Is Fixed, Invert Once
+    const float sigma = 1e-6;
+    Matrix_t M = axis.H + sigma * Matrix_t::Identity() + Config.rho * A.transpose() * A;
+    axis.Minv = M.inverse();
+}
+
+float MpcController::Solve(Axis_t &axis, float position, const Vector_t &reference, float tick_dt)
+{
+    const float sigma   = 1e-6;
+    const float rho     = Config.rho;
+    const float epsilon = 1e-2;
+
+    // Linear Cost Term from Tracking Error and Previous Command
+    Vector_t error = reference - Vector_t::Constant(position);
+    Vector_t f = axis.F * error;
+    f[0] -= 2.0 * Config.r_accel * axis.prev_command;
+
+    // Bounds on Commands and Command Changes, First Step Limited by Real Tick Time
+    float step_accel = axis.max_accel * Config.dt;
+    Vector2_t lower, upper;
+    lower.head<HORIZON>().setConstant(-axis.max_speed);
+    upper.head<HORIZON>().setConstant( axis.max_speed);
+    lower.tail<HORIZON>().setConstant(-step_accel);
+    upper.tail<HORIZON>().setConstant( step_accel);
+    lower[HORIZON] = axis.prev_command - axis.max_accel * tick_dt;
+    upper[HORIZON] = axis.prev_command + axis.max_accel * tick_dt;
+
+    // Warm Start: Shift Last Solution One Step
+    for(int k = 0; k < HORIZON - 1; k++)
+    {
+        axis.x[k] = axis.x[k+1];
+        axis.y[k] = axis.y[k+1];
+        axis.y[HORIZON+k] = axis.y[HORIZON+k+1];
+    }
+    axis.z = (A * axis.x).cwiseMax(lower).cwiseMin(upper);
+
+    int iteration = 0;
+    for(; iteration < Config.max_iterations; iteration++)
+    {
+        axis.x = axis.Minv * (sigma * axis.x - f + A.transpose() * (rho * axis.z - axis.y));
+
+        Vector2_t Ax = A * axis.x;
+        Vector2_t z_prev = axis.z;
+        axis.z = (Ax + axis.y / rho).cwiseMax(lower).cwiseMin(upper);
+        axis.y += rho * (Ax - axis.z);
+
+        // Primal and Dual Residuals
+        float primal = (Ax - axis.z).lpNorm<Eigen::Infinity>();
+        float dual   = rho * (A.transpose() * (axis.z - z_prev)).lpNorm<Eigen::Infinity>();
+        if(primal < epsilon && dual < epsilon)
+        {
+            iteration++;
+            break;
+        }
+    }
+    LastIterations = std::max(LastIterations, iteration);
+
+    // Enforce Hard Bounds on the Applied Command
+    float command = axis.x[0];
+    command = std::min(std::max(command, std::max(lower[0], lower[HORIZON])), std::min(upper[0], upper[HORIZON]));
+
+    axis.prev_command = command;
+    return command;
+}
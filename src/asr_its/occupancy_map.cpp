@@ -0,0 +1,281 @@
+#include "occupancy_map.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+OccupancyMap::OccupancyMap(): width(0), height(0)
+{
+    info.resolution      = 0.05;
+    info.origin_x        = 0.0;
+    info.origin_y        = 0.0;
+    info.origin_theta    = 0.0;
+    info.negate          = false;
+    info.occupied_thresh = 0.65;
+    info.free_thresh     = 0.196;
+}
+
+static std::string Trim(const std::string &text)
+{
+    size_t first = text.find_first_not_of(" \t\r\"'");
+    size_t last = text.find_last_not_of(" \t\r\"'");
+    return first == std::string::npos ? std::string() : text.substr(first, last - first + 1);
+}
+
+bool OccupancyMap::ParseYaml(const std::string &yaml_path, Info_t &info, std::string &error)
+{
+    std::ifstream file(yaml_path.c_str());
+    if(!file)
+    {
+        error = "cannot open " + yaml_path;
+        return false;
+    }
+
+    // map_server Files Are Flat "key: value" Lines, origin Is a Flow Sequence
+    bool has_image = false;
+    bool has_resolution = false;
+    std::string line;
+    while(std::getline(file, line))
+    {
+        line = line.substr(0, line.find('#'));
+        size_t colon = line.find(':');
+        if(colon == std::string::npos)
+        {
+            continue;
+        }
+        std::string key = Trim(line.substr(0, colon));
+        std::string value = Trim(line.substr(colon + 1));
+
+        if(key == "image")
+        {
+            info.image = value;
+            has_image = true;
+        }
+        else if(key == "resolution")
+        {
+            info.resolution = atof(value.c_str());
+            has_resolution = info.resolution > 0.0;
+        }
+        else if(key == "origin")
+        {
+            for(char &c : value)
+            {
+                if(c == '[' || c == ']' || c == ',')
+                {
+                    c = ' ';
+                }
+            }
+            std::istringstream fields(value);
+            if(!(fields >> info.origin_x >> info.origin_y >> info.origin_theta))
+            {
+                error = "malformed origin in " + yaml_path;
+                return false;
+            }
+        }
+        else if(key == "negate")
+        {
+            info.negate = atoi(value.c_str()) != 0;
+        }
+        else if(key == "occupied_thresh")
+        {
+            info.occupied_thresh = atof(value.c_str());
+        }
+        else if(key == "free_thresh")
+        {
+            info.free_thresh = atof(value.c_str());
+        }
+        else if(key == "mode" && value != "trinary")
+        {
+            error = "only trinary maps are supported, " + yaml_path + " is " + value;
+            return false;
+        }
+    }
+
+    if(!has_image || !has_resolution)
+    {
+        error = "image or resolution missing in " + yaml_path;
+        return false;
+    }
+
+    // Image Paths Are Relative to the YAML File
+    if(!info.image.empty() && info.image[0] != '/')
+    {
+        size_t slash = yaml_path.rfind('/');
+        if(slash != std::string::npos)
+        {
+            info.image = yaml_path.substr(0, slash + 1) + info.image;
+        }
+    }
+    return true;
+}
+
+// Next Header Token of a PNM File, Skipping Whitespace and Comments
+static bool ReadToken(std::istream &in, std::string &token)
+{
+    token.clear();
+    int c;
+    while((c = in.get()) != EOF)
+    {
+        if(c == '#')
+        {
+            while((c = in.get()) != EOF && c != '\n');
+            continue;
+        }
+        if(isspace(c))
+        {
+            if(!token.empty())
+            {
+                return true;
+            }
+            continue;
+        }
+        token += (char)c;
+    }
+    return !token.empty();
+}
+
+bool OccupancyMap::LoadImage(const Info_t &map_info, std::string &error)
+{
+    std::ifstream file(map_info.image.c_str(), std::ios::binary);
+    if(!file)
+    {
+        error = "cannot open " + map_info.image;
+        return false;
+    }
+
+    std::string magic, w, h, maxval;
+    if(!ReadToken(file, magic) || (magic != "P5" && magic != "P2") || !ReadToken(file, w) ||
+       !ReadToken(file, h) || !ReadToken(file, maxval))
+    {
+        error = map_info.image + " is not a PGM image";
+        return false;
+    }
+    int image_width = atoi(w.c_str());
+    int image_height = atoi(h.c_str());
+    int max_value = atoi(maxval.c_str());
+    if(image_width <= 0 || image_height <= 0 || max_value <= 0 || max_value > 65535)
+    {
+        error = "unsupported PGM header in " + map_info.image;
+        return false;
+    }
+
+    // Raw Samples in Image Order, Top Row First
+    std::vector<int> samples((size_t)image_width * image_height);
+    if(magic == "P5")
+    {
+        int bytes = max_value > 255 ? 2 : 1;
+        std::vector<unsigned char> raw(samples.size() * bytes);
+        if(!file.read((char*)raw.data(), raw.size()))
+        {
+            error = map_info.image + " is truncated";
+            return false;
+        }
+        for(size_t i = 0; i < samples.size(); i++)
+        {
+            samples[i] = bytes == 2 ? (raw[2 * i] << 8) | raw[2 * i + 1] : raw[i];
+        }
+    }
+    else
+    {
+        std::string token;
+        for(size_t i = 0; i < samples.size(); i++)
+        {
+            if(!ReadToken(file, token))
+            {
+                error = map_info.image + " is truncated";
+                return false;
+            }
+            samples[i] = atoi(token.c_str());
+        }
+    }
+
+    // Trinary Classification of map_server, Image Flipped so Row 0 Is the Bottom
+    info = map_info;
+    width = image_width;
+    height = image_height;
+    cells.resize(samples.size());
+    for(int y = 0; y < height; y++)
+    {
+        const int* row = &samples[(size_t)(height - 1 - y) * width];
+        int8_t* out = &cells[(size_t)y * width];
+        for(int x = 0; x < width; x++)
+        {
+            float value = (float)row[x] / max_value;
+            float occupancy = info.negate ? value : 1.0f - value;
+            if(occupancy > info.occupied_thresh)
+            {
+                out[x] = OCCUPIED;
+            }
+            else if(occupancy < info.free_thresh)
+            {
+                out[x] = FREE;
+            }
+            else
+            {
+                out[x] = UNKNOWN;
+            }
+        }
+    }
+    return true;
+}
+
+bool OccupancyMap::Load(const std::string &yaml_path, std::string &error)
+{
+    Info_t map_info = info;
+    return ParseYaml(yaml_path, map_info, error) && LoadImage(map_info, error);
+}
+
+int OccupancyMap::Width() const
+{
+    return width;
+}
+
+int OccupancyMap::Height() const
+{
+    return height;
+}
+
+float OccupancyMap::Resolution() const
+{
+    return info.resolution;
+}
+
+float OccupancyMap::OriginX() const
+{
+    return info.origin_x;
+}
+
+float OccupancyMap::OriginY() const
+{
+    return info.origin_y;
+}
+
+const OccupancyMap::Info_t& OccupancyMap::Info() const
+{
+    return info;
+}
+
+bool OccupancyMap::WorldToCell(float x, float y, int &cx, int &cy) const
+{
+    float fx = (x - info.origin_x) / info.resolution;
+    float fy = (y - info.origin_y) / info.resolution;
+    if(fx < 0.0 || fy < 0.0 || fx >= width || fy >= height)
+    {
+        return false;
+    }
+    cx = (int)fx;
+    cy = (int)fy;
+    return true;
+}
+
+int8_t OccupancyMap::At(int cx, int cy) const
+{
+    return cells[(size_t)cy * width + cx];
+}
+
+const std::vector<int8_t>& OccupancyMap::Cells() const
+{
+    return cells;
+}
@@ -0,0 +1,99 @@
+#include "omni_kinematics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#define MATH_PI 3.1415926535897932384626433832795
+
+OmniKinematics::OmniKinematics()
+{
+    // Four Wheels on the Diagonals
+    Config_t config;
+    config.wheels           = 4;
+    config.wheel_angle[0]   = MATH_PI / 4;
+    config.wheel_angle[1]   = 3 * MATH_PI / 4;
+    config.wheel_angle[2]   = 5 * MATH_PI / 4;
+    config.wheel_angle[3]   = 7 * MATH_PI / 4;
+    config.base_radius      = 0.2;
+    config.wheel_radius     = 0.05;
+    config.max_wheel_speed  = 9.0;
+    config.angular_scale    = 57.29578;
+    Configure(config);
+}
+
+void OmniKinematics::Configure(const Config_t &config)
+{
+    Settings = config;
+    Settings.wheels = std::min(std::max(Settings.wheels, 3), (int)MAX_WHEELS);
+
+    // Rolling Speed -sin(a) Forward + cos(a) Left + R Yaw Rate, with Forward = c[1] / 100,
+    // Left = -c[0] / 100 and Yaw Rate = c[2] / angular_scale
+    Forward.setZero();
+    for(int i = 0; i < Settings.wheels; i++)
+    {
+        float a = Settings.wheel_angle[i];
+        Forward(i, 0) = -cos(a) / (100.0 * Settings.wheel_radius);
+        Forward(i, 1) = -sin(a) / (100.0 * Settings.wheel_radius);
+        Forward(i, 2) = Settings.base_radius / (Settings.angular_scale * Settings.wheel_radius);
+    }
+
+    // Zero Rows Drop Out of the Normal Equations
+    Eigen::Matrix3f normal = Forward.transpose() * Forward;
+    Backward = normal.inverse() * Forward.transpose();
+}
+
+const OmniKinematics::Config_t& OmniKinematics::Config() const
+{
+    return Settings;
+}
+
+void OmniKinematics::ToWheels(const float command[3], float wheel[]) const
+{
+    Eigen::Vector3f c(command[0], command[1], command[2]);
+    Eigen::Matrix<float, MAX_WHEELS, 1> w = Forward * c;
+
+    for(int i = 0; i < Settings.wheels; i++)
+    {
+        wheel[i] = w(i);
+    }
+}
+
+void OmniKinematics::ToCommand(const float wheel[], float command[3]) const
+{
+    Eigen::Matrix<float, MAX_WHEELS, 1> w = Eigen::Matrix<float, MAX_WHEELS, 1>::Zero();
+    for(int i = 0; i < Settings.wheels; i++)
+    {
+        w(i) = wheel[i];
+    }
+
+    Eigen::Vector3f c = Backward * w;
+    command[0] = c(0);
+    command[1] = c(1);
+    command[2] = c(2);
+}
+
+float OmniKinematics::Saturate(float command[3]) const
+{
+    float wheel[MAX_WHEELS];
+    ToWheels(command, wheel);
+
+    float fastest = 0.0;
+    for(int i = 0; i < Settings.wheels; i++)
+    {
+        fastest = std::max(fastest, (float)fabs(wheel[i]));
+    }
+
+    if(fastest <= Settings.max_wheel_speed)
+    {
+        return 1.0;
+    }
+
+    // Same Factor on Every Wheel, Mapped Back to the Command
+    float scale = Settings.max_wheel_speed / fastest;
+    for(int i = 0; i < Settings.wheels; i++)
+    {
+        wheel[i] *= scale;
+    }
+    ToCommand(wheel, command);
+    return scale;
+}
@@ -0,0 +1,86 @@
+#include "omni_sim.h"
+
+#include <algorithm>
+#include <cmath>
+
+static float WrapAngle(float angle)
+{
+    return atan2(sin(angle), cos(angle));
+}
+
+OmniBaseSim::OmniBaseSim()
+{
+    Config_t config;
+    config.tau_linear        = 0.15;
+    config.tau_angular       = 0.1;
+    config.max_accel         = 80.0;
+    config.max_angular_accel = 120.0;
+    config.angular_scale     = 57.29578;
+    config.odom_scale_error  = 0.0;
+    Configure(config);
+
+    Pose_t origin = {0.0, 0.0, 0.0};
+    Reset(origin);
+}
+
+void OmniBaseSim::Configure(const Config_t &config)
+{
+    Config = config;
+}
+
+void OmniBaseSim::Reset(const Pose_t &pose)
+{
+    Truth = pose;
+    OdomPose.x = OdomPose.y = OdomPose.theta = 0.0;
+    Vel[0] = Vel[1] = Vel[2] = 0.0;
+}
+
+void OmniBaseSim::Step(const float command[3], float dt)
+{
+    if(dt <= 0.0)
+    {
+        return;
+    }
+
+    // Actuator Response: First-Order Lag Bounded by the Acceleration Limit
+    for(int i = 0; i < 3; i++)
+    {
+        float tau = (i < 2) ? Config.tau_linear : Config.tau_angular;
+        float max_step = ((i < 2) ? Config.max_accel : Config.max_angular_accel) * dt;
+        float change = (tau > 0.0) ? (command[i] - Vel[i]) * std::min(1.0f, dt / tau) : command[i] - Vel[i];
+        Vel[i] += std::min(std::max(change, -max_step), max_step);
+    }
+
+    Pose_t body = Velocity();
+
+    // Integrate at the Midpoint Heading
+    float mid = Truth.theta + 0.5 * body.theta * dt;
+    Truth.x += (body.x * cos(mid) - body.y * sin(mid)) * dt;
+    Truth.y += (body.x * sin(mid) + body.y * cos(mid)) * dt;
+    Truth.theta = WrapAngle(Truth.theta + body.theta * dt);
+
+    float scale = 1.0 + Config.odom_scale_error;
+    float odom_mid = OdomPose.theta + 0.5 * body.theta * dt;
+    OdomPose.x += scale * (body.x * cos(odom_mid) - body.y * sin(odom_mid)) * dt;
+    OdomPose.y += scale * (body.x * sin(odom_mid) + body.y * cos(odom_mid)) * dt;
+    OdomPose.theta = WrapAngle(OdomPose.theta + body.theta * dt);
+}
+
+OmniBaseSim::Pose_t OmniBaseSim::Pose() const
+{
+    return Truth;
+}
+
+OmniBaseSim::Pose_t OmniBaseSim::Odom() const
+{
+    return OdomPose;
+}
+
+OmniBaseSim::Pose_t OmniBaseSim::Velocity() const
+{
+    Pose_t body;
+    body.x = Vel[1] / 100.0;
+    body.y = -Vel[0] / 100.0;
+    body.theta = Vel[2] / Config.angular_scale;
+    return body;
+}
@@ -0,0 +1,272 @@
+#include "path_controllers.h"
+
+#include <cmath>
+
+#define MATH_PI 3.1415926535897932384626433832795
+
+static float NearestAngle(float error)
+{
+    if(fabs(error) >= MATH_PI)
+    {
+        if(error > 0)
+        {
+            error = error - 2*MATH_PI;
+        }
+        else
+        {
+            error = error + 2*MATH_PI;
+        }
+    }
+    return error;
+}
+
+PathControllerConfig_t DefaultPathControllerConfig()
+{
+    PathControllerConfig_t config = {
+        // PID {2.5, 2.5, 0.2}, ki {0.0005, 0.0005, 0.0}, kd {1.8, 1.8, 0.13}
+        {{2.3, 2.3, 0.2}, {0.0, 0.0, 0.0}, {1.8, 1.8, 0.13}},
+        // PID by Nawab, Heading and Distance; Distance kp Was 0.5 in the Old Error Frame
+        {{0.2, 2.3}, {0.0, 0.0}, {0.17, 0.0}},
+        // LQR, P2P Q = diag(30, 30, 10), PTrack diag(225, 225, 50)
+        {225.0, 50.0, 1.0, 30.0},
+        // MPC
+        {0.1, 2000.0, 200.0, 0.01, 0.05, 30.0, 30.0, 60.0, 60.0, 57.29578, 0.1, 40}
+    };
+    return config;
+}
+
+bool MakePathController(const std::string &name, const PathControllerConfig_t &config, PathController_t &controller)
+{
+    if(name == "lqr")
+    {
+        controller.emplace<LqrController>(config.lqr);
+    }
+    else if(name == "pid")
+    {
+        controller.emplace<PidController>(config.pid);
+    }
+    else if(name == "pid_v2")
+    {
+        controller.emplace<PidV2Controller>(config.pid_v2);
+    }
+    else if(name == "mpc")
+    {
+        controller.emplace<MpcTracker>(config.mpc);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+const char* PathControllerName(const PathController_t &controller)
+{
+    static const char* names[] = {"lqr", "pid", "pid_v2", "mpc"};
+    return names[controller.index()];
+}
+
+// PID Controller
+PidController::PidController(): PidController(DefaultPathControllerConfig().pid){}
+
+PidController::PidController(const Config_t &config): Config(config)
+{
+    Reset();
+}
+
+void PidController::Reset()
+{
+    for(int i = 0; i <= 2; i++)
+    {
+        prevError[i] = 0.0;
+        sumError[i] = 0.0;
+    }
+}
+
+TrackingPose_t PidController::Compute(const TrackingInput_t &input)
+{
+    TrackingPose_t robot_vel;
+    float output[3] = {0.0, 0.0, 0.0};
+    float error[3];
+
+    error[0] = input.target.x - input.robot.x;
+    error[1] = input.target.y - input.robot.y;
+    error[2] = NearestAngle(input.target.theta - input.robot.theta);
+
+    for(int i=0 ; i<=2 ; i++){
+        sumError[i] += error[i];
+
+        float proportional = Config.kp[i] * error[i];
+        float integral = Config.ki[i] * sumError[i];
+        float derivative = Config.kd[i] * (error[i] - prevError[i]);
+
+        prevError[i] = error[i];
+
+        output[i] = proportional + integral + derivative;
+    }
+
+    // Get Theta Control Only if Heading Error more than 30 degree
+    if(error[2] >= MATH_PI/6 || error[2] <= -MATH_PI/6)
+    {
+        output[0] = 0.0;
+        output[1] = 0.0;
+    }
+
+    robot_vel.x = output[0]*100;
+    robot_vel.y = output[1]*100;
+    robot_vel.theta = output[2]*100;
+
+    return robot_vel;
+}
+
+// PID Controller by Nawab
+PidV2Controller::PidV2Controller(): PidV2Controller(DefaultPathControllerConfig().pid_v2){}
+
+PidV2Controller::PidV2Controller(const Config_t &config): Config(config)
+{
+    Reset();
+}
+
+void PidV2Controller::Reset()
+{
+    for(int i = 0; i <= 1; i++)
+    {
+        prevError[i] = 0.0;
+        sumError[i] = 0.0;
+    }
+}
+
+TrackingPose_t PidV2Controller::Compute(const TrackingInput_t &input)
+{
+    TrackingPose_t robot_vel;
+    float output[2] = {0.0, 0.0};
+    float error[2]; //Error Heading = [0], Error Distance = [1]
+
+    // Heading Toward the Target Heading, Speed Along the Bearing to the Target Point; Both Are
+    // Map Frame Like the Other Controllers, the Caller Turns Them into Local Velocities
+    float dx = input.target.x - input.robot.x;
+    float dy = input.target.y - input.robot.y;
+    float bearing = atan2(dy, dx);
+    error[0] = NearestAngle(input.target.theta - input.robot.theta);
+    error[1] = sqrt(dx * dx + dy * dy);
+
+    for(int i=0 ; i<=1 ; i++){
+        sumError[i] += error[i];
+
+        float proportional = Config.kp[i] * error[i];
+        float integral = Config.ki[i] * sumError[i];
+        float derivative = Config.kd[i] * (error[i] - prevError[i]);
+
+        prevError[i] = error[i];
+
+        output[i] = proportional + integral + derivative;
+    }
+
+    robot_vel.theta = output[0]*100;
+    robot_vel.x = output[1]*100 * cos(bearing);
+    robot_vel.y = output[1]*100 * sin(bearing);
+
+    return robot_vel;
+}
+
+// LQR Controller
+LqrController::LqrController(): LqrController(DefaultPathControllerConfig().lqr){}
+
+LqrController::LqrController(const Config_t &config): Config(config)
+{
+    const int maxIterations = 100;
+    const double convergenceThreshold = 1e-6;
+    float dt = 1;
+
+    // Define the system dynamics matrices A, B
+    Eigen::Matrix3d A = Eigen::Matrix3d::Identity();
+    Eigen::Matrix3d B = -dt * Eigen::Matrix3d::Identity();
+
+    // Define the Q and R matrices
+    Eigen::Matrix3d Q = Eigen::Vector3d(Config.q_position, Config.q_position, Config.q_theta).asDiagonal();
+    Eigen::Matrix3d R = Config.r * Eigen::Matrix3d::Identity();
+
+    // Solve the Algebraic Riccati Equation Once, the Gain Does Not Depend on the Error
+    Eigen::Matrix3d P = Q;
+    for (int i = 0; i < maxIterations; ++i) {
+        Eigen::Matrix3d P_prev = P;
+        P = A.transpose() * P * A - A.transpose() * P * B * (R + B.transpose() * P * B).inverse() * B.transpose() * P * A + Q;
+
+        // Check for convergence
+        if ((P - P_prev).norm() < convergenceThreshold) {
+            break;
+        }
+    }
+
+    // Calculate the gain matrix K
+    K = (R.inverse() * B.transpose() * P).cast<float>();
+}
+
+void LqrController::Reset(){}
+
+TrackingPose_t LqrController::Compute(const TrackingInput_t &input)
+{
+    TrackingPose_t robot_vel;
+
+    Eigen::Vector3f Error(input.target.x - input.robot.x,
+                          input.target.y - input.robot.y,
+                          NearestAngle(input.target.theta - input.robot.theta));
+    Eigen::Vector3f U = -K * Error;
+
+    // Speed Limiter Only, Translation Follows the Bound Given for This Tick
+    float linear_limit = (input.max_speed > 0.0) ? input.max_speed : Config.max_speed;
+    for(int i=0 ; i<=2 ; i++){
+        float limit = (i < 2) ? linear_limit : Config.max_speed;
+        if(U[i] >= limit){
+            U[i] = limit;
+        }
+        else if(U[i] <= -limit){
+            U[i] = -limit;
+        }
+    }
+
+    robot_vel.x = U[0];
+    robot_vel.y = U[1];
+    robot_vel.theta = U[2];
+
+    return robot_vel;
+}
+
+// MPC over the Upcoming Stretch of Path
+MpcTracker::MpcTracker(){}
+
+MpcTracker::MpcTracker(const MpcController::Config_t &config)
+{
+    Mpc.Configure(config);
+}
+
+void MpcTracker::Reset()
+{
+    Mpc.Reset();
+}
+
+TrackingPose_t MpcTracker::Compute(const TrackingInput_t &input)
+{
+    MpcController::Pose_t current = {input.robot.x, input.robot.y, input.robot.theta};
+    MpcController::Pose_t reference[MpcController::HORIZON];
+    for(int k = 0; k < MpcController::HORIZON; k++)
+    {
+        reference[k].x = input.horizon[k].x;
+        reference[k].y = input.horizon[k].y;
+        reference[k].theta = input.horizon[k].theta;
+    }
+
+    // Restart Warm Start After a Pause
+    float tick_dt = input.dt;
+    if(tick_dt <= 0.0 || tick_dt > 0.1)
+    {
+        Mpc.Reset();
+        tick_dt = 0.005;
+    }
+
+    Mpc.SetMaxSpeed(input.max_speed);
+    MpcController::Pose_t command = Mpc.Compute(current, reference, tick_dt);
+
+    TrackingPose_t robot_vel = {command.x, command.y, command.theta};
+    return robot_vel;
+}
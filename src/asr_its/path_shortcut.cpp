@@ -0,0 +1,223 @@
+#include "path_shortcut.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+PathShortcut::PathShortcut()
+{
+    config.inflation_radius  = 0.3;
+    config.smooth_iterations = 2;
+    config.corner_cut        = 0.4;
+    config.max_spacing       = 0.5;
+    stats = Stats_t();
+}
+
+void PathShortcut::Configure(const Config_t &config)
+{
+    this->config = config;
+}
+
+const PathShortcut::Config_t& PathShortcut::Config() const
+{
+    return config;
+}
+
+void PathShortcut::SetMap(const float* distance, int width, int height, float resolution,
+                          float origin_x, float origin_y)
+{
+    grid.Build(distance, width, height, resolution, origin_x, origin_y, config.inflation_radius);
+}
+
+void PathShortcut::SetMap(const DistanceField &field)
+{
+    SetMap(field.Data().data(), field.Width(), field.Height(), field.Resolution(), field.OriginX(), field.OriginY());
+}
+
+bool PathShortcut::Ready() const
+{
+    return !grid.Empty();
+}
+
+bool PathShortcut::Free(int cx, int cy) const
+{
+    return grid.Free(cx, cy);
+}
+
+const PathShortcut::Stats_t& PathShortcut::Stats() const
+{
+    return stats;
+}
+
+bool PathShortcut::LineOfSight(float x0, float y0, float x1, float y1)
+{
+    stats.line_checks++;
+    float resolution = grid.Resolution();
+    float fx = (x0 - grid.OriginX()) / resolution, fy = (y0 - grid.OriginY()) / resolution;
+    float gx = (x1 - grid.OriginX()) / resolution, gy = (y1 - grid.OriginY()) / resolution;
+    int cx = (int)floor(fx), cy = (int)floor(fy);
+    int ex = (int)floor(gx), ey = (int)floor(gy);
+
+    // Bresenham Style Integer Steps, but Driven by the Exact Endpoints so Every Cell the Segment
+    // Crosses Is Tested, and Both Side Cells Where It Passes Through a Corner
+    float dx = gx - fx, dy = gy - fy;
+    int sx = dx > 0 ? 1 : -1, sy = dy > 0 ? 1 : -1;
+    float step_x = dx != 0.0 ? fabs(1.0f / dx) : INFINITY;
+    float step_y = dy != 0.0 ? fabs(1.0f / dy) : INFINITY;
+    float next_x = dx != 0.0 ? (sx > 0 ? cx + 1 - fx : fx - cx) * step_x : INFINITY;
+    float next_y = dy != 0.0 ? (sy > 0 ? cy + 1 - fy : fy - cy) * step_y : INFINITY;
+    // Within a Ten Thousandth of a Cell of a Corner Counts as Through It, Rounding Must Not Pick a Side
+    float tie = 1e-4f / std::max(std::max(fabsf(dx), fabsf(dy)), 1.0f);
+    int steps = abs(ex - cx) + abs(ey - cy);
+    for(int i = 0; i <= steps; i++)
+    {
+        if(!Free(cx, cy))
+        {
+            return false;
+        }
+        if(cx == ex && cy == ey)
+        {
+            return true;
+        }
+        if(fabs(next_x - next_y) <= tie)
+        {
+            if(!Free(cx + sx, cy) || !Free(cx, cy + sy))
+            {
+                return false;
+            }
+            cx += sx;
+            cy += sy;
+            next_x += step_x;
+            next_y += step_y;
+            i++;
+        }
+        else if(next_x < next_y)
+        {
+            cx += sx;
+            next_x += step_x;
+        }
+        else
+        {
+            cy += sy;
+            next_y += step_y;
+        }
+    }
+    return Free(ex, ey);
+}
+
+// Greedy: From Each Kept Point, Run Ahead While the Straight Line Stays Free
+void PathShortcut::Shortcut(const std::vector<Point_t> &path, std::vector<Point_t> &out)
+{
+    out.clear();
+    out.push_back(path[0]);
+    size_t anchor = 0;
+    while(anchor + 1 < path.size())
+    {
+        size_t reach = anchor + 1;
+        while(reach + 1 < path.size() &&
+              LineOfSight(path[anchor].x, path[anchor].y, path[reach + 1].x, path[reach + 1].y))
+        {
+            reach++;
+        }
+        out.push_back(path[reach]);
+        anchor = reach;
+    }
+}
+
+// Chaikin Corner Cutting, Each Corner Replaced by Two Points on Its Segments When the Cut Is Free.
+// A Quarter of Each Segment at Most, so Cuts from Both Ends Never Cross.
+void PathShortcut::Smooth(std::vector<Point_t> &points)
+{
+    for(int pass = 0; pass < config.smooth_iterations && points.size() > 2; pass++)
+    {
+        scratch.clear();
+        scratch.push_back(points.front());
+        for(size_t i = 1; i + 1 < points.size(); i++)
+        {
+            const Point_t &prev = points[i - 1], &corner = points[i], &next = points[i + 1];
+            float length_in = hypot(corner.x - prev.x, corner.y - prev.y);
+            float length_out = hypot(next.x - corner.x, next.y - corner.y);
+            if(length_in < 1e-6 || length_out < 1e-6)
+            {
+                scratch.push_back(corner);
+                continue;
+            }
+            float cut_in = std::min(0.25f * length_in, config.corner_cut) / length_in;
+            float cut_out = std::min(0.25f * length_out, config.corner_cut) / length_out;
+            Point_t a = {corner.x + (prev.x - corner.x) * cut_in, corner.y + (prev.y - corner.y) * cut_in, corner.theta};
+            Point_t b = {corner.x + (next.x - corner.x) * cut_out, corner.y + (next.y - corner.y) * cut_out, corner.theta};
+            if(LineOfSight(a.x, a.y, b.x, b.y))
+            {
+                scratch.push_back(a);
+                scratch.push_back(b);
+            }
+            else
+            {
+                scratch.push_back(corner);
+            }
+        }
+        scratch.push_back(points.back());
+        points.swap(scratch);
+    }
+}
+
+void PathShortcut::Resample(const std::vector<Point_t> &points, std::vector<Point_t> &out)
+{
+    out.clear();
+    out.push_back(points.front());
+    for(size_t i = 1; i < points.size(); i++)
+    {
+        const Point_t &from = points[i - 1], &to = points[i];
+        float length = hypot(to.x - from.x, to.y - from.y);
+        int pieces = config.max_spacing > 0.0 ? (int)ceil(length / config.max_spacing) : 1;
+        for(int k = 1; k < pieces; k++)
+        {
+            float t = (float)k / pieces;
+            Point_t point = {from.x + (to.x - from.x) * t, from.y + (to.y - from.y) * t, from.theta};
+            out.push_back(point);
+        }
+        out.push_back(to);
+    }
+}
+
+void PathShortcut::Process(const std::vector<Point_t> &path, std::vector<Point_t> &out)
+{
+    stats = Stats_t();
+    stats.input_points = path.size();
+    for(size_t i = 1; i < path.size(); i++)
+    {
+        stats.input_length += hypot(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y);
+    }
+    if(!Ready() || path.size() < 3)
+    {
+        out = path;
+        stats.output_points = stats.input_points;
+        stats.output_length = stats.input_length;
+        return;
+    }
+
+    Shortcut(path, work);
+    Smooth(work);
+    Resample(work, out);
+
+    // Heading Along the New Segments, the Final Heading from the Original Path
+    for(size_t i = 0; i + 1 < out.size(); i++)
+    {
+        float dx = out[i + 1].x - out[i].x, dy = out[i + 1].y - out[i].y;
+        if(dx != 0.0 || dy != 0.0)
+        {
+            out[i].theta = atan2(dy, dx);
+        }
+        else if(i > 0)
+        {
+            out[i].theta = out[i - 1].theta;
+        }
+    }
+    out.back().theta = path.back().theta;
+
+    stats.output_points = out.size();
+    for(size_t i = 1; i < out.size(); i++)
+    {
+        stats.output_length += hypot(out[i].x - out[i - 1].x, out[i].y - out[i - 1].y);
+    }
+}
@@ -0,0 +1,224 @@
+#include "path_spline.h"
+
+#include <algorithm>
+#include <cmath>
+
+#define MATH_PI 3.1415926535897932384626433832795
+
+static float WrapAngle(float angle)
+{
+    while(angle > MATH_PI)
+    {
+        angle -= 2*MATH_PI;
+    }
+    while(angle < -MATH_PI)
+    {
+        angle += 2*MATH_PI;
+    }
+    return angle;
+}
+
+PathSpline::PathSpline(){}
+
+void PathSpline::Fit(const std::vector<float> &x, const std::vector<float> &y, const std::vector<float> &theta)
+{
+    Clear();
+
+    // Drop Repeated Waypoints (Zero Length Segments)
+    std::vector<float> px, py, pt;
+    for(size_t i = 0; i < x.size() && i < y.size() && i < theta.size(); i++)
+    {
+        if(!px.empty() && std::hypot(x[i] - px.back(), y[i] - py.back()) < 1e-4)
+        {
+            pt.back() = theta[i];
+            continue;
+        }
+        px.push_back(x[i]);
+        py.push_back(y[i]);
+        pt.push_back(theta[i]);
+    }
+
+    int n = px.size();
+    if(n == 0)
+    {
+        return;
+    }
+
+    // Single Waypoint is a Zero Length Path
+    if(n == 1)
+    {
+        Segment_t seg = {0, 0, 0, px[0], 0, 0, 0, py[0], pt[0], 0};
+        segment.push_back(seg);
+        table_s.push_back(0.0);
+        table_x.push_back(px[0]);
+        table_y.push_back(py[0]);
+        return;
+    }
+
+    segment.reserve(n - 1);
+    for(int i = 0; i < n - 1; i++)
+    {
+        // Control Points, Mirror the Ends
+        float x0 = (i > 0)     ? px[i-1] : 2*px[0] - px[1];
+        float y0 = (i > 0)     ? py[i-1] : 2*py[0] - py[1];
+        float x1 = px[i],   y1 = py[i];
+        float x2 = px[i+1], y2 = py[i+1];
+        float x3 = (i < n - 2) ? px[i+2] : 2*px[n-1] - px[n-2];
+        float y3 = (i < n - 2) ? py[i+2] : 2*py[n-1] - py[n-2];
+
+        // Centripetal Knot Spacing (alpha = 0.5)
+        float dt0 = std::max(std::sqrt(std::hypot(x1 - x0, y1 - y0)), 1e-4f);
+        float dt1 = std::max(std::sqrt(std::hypot(x2 - x1, y2 - y1)), 1e-4f);
+        float dt2 = std::max(std::sqrt(std::hypot(x3 - x2, y3 - y2)), 1e-4f);
+
+        // Hermite Tangents Scaled to u in [0, 1]
+        float m1x = dt1 * ((x1 - x0)/dt0 - (x2 - x0)/(dt0 + dt1) + (x2 - x1)/dt1);
+        float m1y = dt1 * ((y1 - y0)/dt0 - (y2 - y0)/(dt0 + dt1) + (y2 - y1)/dt1);
+        float m2x = dt1 * ((x2 - x1)/dt1 - (x3 - x1)/(dt1 + dt2) + (x3 - x2)/dt2);
+        float m2y = dt1 * ((y2 - y1)/dt1 - (y3 - y1)/(dt1 + dt2) + (y3 - y2)/dt2);
+
+        Segment_t seg;
+        seg.ax = 2*x1 - 2*x2 + m1x + m2x;
+        seg.bx = -3*x1 + 3*x2 - 2*m1x - m2x;
+        seg.cx = m1x;
+        seg.dx = x1;
+        seg.ay = 2*y1 - 2*y2 + m1y + m2y;
+        seg.by = -3*y1 + 3*y2 - 2*m1y - m2y;
+        seg.cy = m1y;
+        seg.dy = y1;
+        seg.theta0 = pt[i];
+        seg.dtheta = WrapAngle(pt[i+1] - pt[i]);
+        segment.push_back(seg);
+    }
+
+    // Build Arc Length Table
+    int table_size = segment.size() * TABLE_RES + 1;
+    table_s.reserve(table_size);
+    table_x.reserve(table_size);
+    table_y.reserve(table_size);
+
+    float s = 0.0;
+    float prev_x = px[0], prev_y = py[0];
+    table_s.push_back(0.0);
+    table_x.push_back(prev_x);
+    table_y.push_back(prev_y);
+
+    for(size_t j = 0; j < segment.size(); j++)
+    {
+        for(int k = 1; k <= TABLE_RES; k++)
+        {
+            float sx, sy;
+            Evaluate(segment[j], (float)k / TABLE_RES, sx, sy);
+            s += std::hypot(sx - prev_x, sy - prev_y);
+            table_s.push_back(s);
+            table_x.push_back(sx);
+            table_y.push_back(sy);
+            prev_x = sx;
+            prev_y = sy;
+        }
+    }
+}
+
+void PathSpline::Clear()
+{
+    segment.clear();
+    table_s.clear();
+    table_x.clear();
+    table_y.clear();
+}
+
+bool PathSpline::Empty() const
+{
+    return segment.empty();
+}
+
+float PathSpline::Length() const
+{
+    return table_s.empty() ? 0.0 : table_s.back();
+}
+
+PathSpline::Sample_t PathSpline::Sample(float s) const
+{
+    if(table_s.size() < 2)
+    {
+        return SampleTable(0, 0.0);
+    }
+
+    s = std::min(std::max(s, 0.0f), Length());
+
+    // Find Table Interval Containing s
+    int idx = std::upper_bound(table_s.begin(), table_s.end(), s) - table_s.begin() - 1;
+    idx = std::min(std::max(idx, 0), (int)table_s.size() - 2);
+
+    float ds = table_s[idx+1] - table_s[idx];
+    float frac = (ds > 1e-9) ? (s - table_s[idx]) / ds : 0.0;
+
+    return SampleTable(idx, frac);
+}
+
+float PathSpline::Project(float x, float y, float s_min, float s_max) const
+{
+    if(table_s.size() < 2)
+    {
+        return 0.0;
+    }
+
+    int first = std::upper_bound(table_s.begin(), table_s.end(), s_min) - table_s.begin() - 1;
+    int last  = std::lower_bound(table_s.begin(), table_s.end(), s_max) - table_s.begin();
+    first = std::max(first, 0);
+    last  = std::min(last, (int)table_s.size() - 1);
+
+    float best_s = std::min(std::max(s_min, 0.0f), Length());
+    float best_dist = INFINITY;
+
+    // Closest Point on Each Chord of the Table
+    for(int i = first; i < last; i++)
+    {
+        float cx = table_x[i+1] - table_x[i];
+        float cy = table_y[i+1] - table_y[i];
+        float len2 = cx*cx + cy*cy;
+        float t = 0.0;
+        if(len2 > 1e-12)
+        {
+            t = ((x - table_x[i])*cx + (y - table_y[i])*cy) / len2;
+            t = std::min(std::max(t, 0.0f), 1.0f);
+        }
+
+        float ex = table_x[i] + t*cx - x;
+        float ey = table_y[i] + t*cy - y;
+        float dist = ex*ex + ey*ey;
+        if(dist < best_dist)
+        {
+            best_dist = dist;
+            best_s = table_s[i] + t*(table_s[i+1] - table_s[i]);
+        }
+    }
+
+    return best_s;
+}
+
+void PathSpline::Evaluate(const Segment_t &seg, float u, float &x, float &y) const
+{
+    x = ((seg.ax*u + seg.bx)*u + seg.cx)*u + seg.dx;
+    y = ((seg.ay*u + seg.by)*u + seg.cy)*u + seg.dy;
+}
+
+PathSpline::Sample_t PathSpline::SampleTable(int idx, float frac) const
+{
+    Sample_t sample = {0.0, 0.0, 0.0};
+    if(segment.empty())
+    {
+        return sample;
+    }
+
+    // Map Table Position Back to Spline Parameter
+    int j = std::min(idx / TABLE_RES, (int)segment.size() - 1);
+    float u = ((idx - j*TABLE_RES) + frac) / TABLE_RES;
+    u = std::min(std::max(u, 0.0f), 1.0f);
+
+    const Segment_t &seg = segment[j];
+    Evaluate(seg, u, sample.x, sample.y);
+    sample.theta = WrapAngle(seg.theta0 + seg.dtheta*u);
+
+    return sample;
+}
@@ -0,0 +1,301 @@
+#include "path_tracking.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#define MATH_PI 3.1415926535897932384626433832795
+
+void ClearTrackingPath(TrackingPath_t &path)
+{
+    while(!path.x.empty())
+    {
+        path.x.pop();
+        path.y.pop();
+        path.theta.pop();
+    }
+    path.curve.Clear();
+    path.progress = 0.0;
+}
+
+void SwapTrackingPath(TrackingPath_t &a, TrackingPath_t &b)
+{
+    a.x.swap(b.x);
+    a.y.swap(b.y);
+    a.theta.swap(b.theta);
+    std::swap(a.curve, b.curve);
+    std::swap(a.progress, b.progress);
+}
+
+TrackingPose_t PurePursuit(TrackingPose_t robot_pose, TrackingPath_t &path, float offset, bool obstacle, bool &finished)
+{
+    TrackingPose_t target_pose;
+    target_pose = robot_pose;
+
+    float distance = 0.0;
+    float theta_error = 0.0;
+    float dx, dy, dot_product;
+    int pathLeft = path.x.size();
+
+    finished = false;
+
+    // // Collision Avoidance Mode
+    if(obstacle)
+    {
+        offset *= 10;
+        while(path.x.size() > 1)
+        {
+            // Check for lookahead point
+            target_pose.x = path.x.front();
+            target_pose.y = path.y.front();
+            target_pose.theta = path.theta.front();
+            distance = sqrt(pow((target_pose.x - robot_pose.x), 2) + pow((target_pose.y - robot_pose.y), 2));
+
+            // Check if the path point is behind the vehicle
+            dx = target_pose.x - robot_pose.x;
+            dy = target_pose.y - robot_pose.y;
+            dot_product = dx * cos(robot_pose.theta) + dy * sin(robot_pose.theta);
+
+            if(distance >= offset && dot_product > 0)
+            {
+                return target_pose;
+            }
+            else
+            {
+                path.x.pop(); path.y.pop(); path.theta.pop();
+            }
+        }
+        // If Path Left is 1
+        target_pose.x = path.x.front();
+        target_pose.y = path.y.front();
+        target_pose.theta = path.theta.front();
+
+        // Check Distance and Theta Error for Last Target Point
+        distance = sqrt(pow((target_pose.x - robot_pose.x), 2) + pow((target_pose.y - robot_pose.y), 2));
+        theta_error = target_pose.theta - robot_pose.theta;
+        
+        if(fabs(theta_error) >= MATH_PI)
+        {
+            if(theta_error > 0)
+            {
+                theta_error = theta_error - 2*MATH_PI;
+            }
+            else
+            {
+                theta_error = theta_error + 2*MATH_PI;
+            }
+        }
+
+        //Untuk Nawab 
+        //(distance <= 0.1 && theta_error <= MATH_PI/18 && theta_error >= -MATH_PI/18)
+        if(distance <= 0.033 && theta_error <= MATH_PI/36 && theta_error >= -MATH_PI/36)
+        {
+            // Stop the Robot and Clear Path
+            path.x.pop(); target_pose.x = robot_pose.x;
+            path.y.pop(); target_pose.y = robot_pose.y;
+            path.theta.pop(); target_pose.theta = robot_pose.theta;
+            finished = true;
+        }
+    }
+
+    // Normal Mode
+    else
+    {
+        // Define Next Target Pose
+        target_pose.x = path.x.front();
+        target_pose.y = path.y.front();
+        target_pose.theta = path.theta.front();
+
+        // Check for Distance Error
+        distance = sqrt(pow((path.x.front() - robot_pose.x), 2) + pow((path.y.front() - robot_pose.y), 2));
+        
+        // Check for Theta Error
+        // delta_heading = path.theta.front() - robot_pose.theta;        
+        // if(abs(delta_heading) >= MATH_PI)
+        // {
+        //     if(delta_heading > 0)
+        //     {
+        //         delta_heading = delta_heading - 2*MATH_PI;
+        //     }
+        //     else
+        //     {
+        //         delta_heading = delta_heading + 2*MATH_PI;
+        //     }
+        // }  
+
+        if(pathLeft > 1)
+        {   
+            while(distance < offset)
+            {
+                path.x.pop(); target_pose.x = path.x.front();
+                path.y.pop(); target_pose.y = path.y.front();  
+                path.theta.pop(); target_pose.theta = path.theta.front();
+                if(path.x.size() <= 1)
+                    break;
+                distance = sqrt(pow((target_pose.x - robot_pose.x), 2) + pow((target_pose.y - robot_pose.y), 2));
+            }
+        }
+
+        else
+        {
+            target_pose.x = path.x.front();
+            target_pose.y = path.y.front();
+            target_pose.theta = path.theta.front()/* - 180 * (MATH_PI/180)*/;
+
+            // Check Distance and Theta Error for Last Target Point
+            distance = sqrt(pow((target_pose.x - robot_pose.x), 2) + pow((target_pose.y - robot_pose.y), 2));
+            theta_error = target_pose.theta - robot_pose.theta;
+            
+            if(fabs(theta_error) >= MATH_PI)
+            {
+                if(theta_error > 0)
+                {
+                    theta_error = theta_error - 2*MATH_PI;
+                }
+                else
+                {
+                    theta_error = theta_error + 2*MATH_PI;
+                }
+            }
+
+            if(distance <= 0.033 && theta_error <= MATH_PI/36 && theta_error >= -MATH_PI/36)
+            {
+            // Stop the Robot and Clear Path
+            path.x.pop(); target_pose.x = robot_pose.x;
+            path.y.pop(); target_pose.y = robot_pose.y;
+            path.theta.pop(); target_pose.theta = robot_pose.theta;
+            finished = true;
+            }
+        }
+    }
+    return target_pose;
+}
+
+TrackingPose_t PurePursuitSpline(TrackingPose_t robot_pose, TrackingPath_t &path, float offset, bool obstacle, bool &finished)
+{
+    TrackingPose_t target_pose;
+    target_pose = robot_pose;
+
+    PathSpline::Sample_t sample;
+    float distance = 0.0;
+    float theta_error = 0.0;
+
+    finished = false;
+
+    // Collision Avoidance Mode Looks Further Ahead
+    if(obstacle)
+    {
+        offset *= 10;
+    }
+
+    // Advance Along the Curve to the Closest Point, Never Backwards
+    path.progress = path.curve.Project(robot_pose.x, robot_pose.y, path.progress, path.progress + 1.0);
+
+    // Lookahead Point at Any Arc Length
+    if(path.progress + offset < path.curve.Length())
+    {
+        sample = path.curve.Sample(path.progress + offset);
+        target_pose.x = sample.x;
+        target_pose.y = sample.y;
+        target_pose.theta = sample.theta;
+        return target_pose;
+    }
+
+    // Lookahead Passed the End, Target the Last Point
+    sample = path.curve.Sample(path.curve.Length());
+    target_pose.x = sample.x;
+    target_pose.y = sample.y;
+    target_pose.theta = sample.theta;
+
+    // Check Distance and Theta Error for Last Target Point
+    distance = sqrt(pow((target_pose.x - robot_pose.x), 2) + pow((target_pose.y - robot_pose.y), 2));
+    theta_error = target_pose.theta - robot_pose.theta;
+
+    if(fabs(theta_error) >= MATH_PI)
+    {
+        if(theta_error > 0)
+        {
+            theta_error = theta_error - 2*MATH_PI;
+        }
+        else
+        {
+            theta_error = theta_error + 2*MATH_PI;
+        }
+    }
+
+    if(distance <= 0.033 && theta_error <= MATH_PI/36 && theta_error >= -MATH_PI/36)
+    {
+        // Stop the Robot and Clear Path
+        ClearTrackingPath(path);
+        target_pose = robot_pose;
+        finished = true;
+    }
+
+    return target_pose;
+}
+
+void FillHorizon(const TrackingPath_t &path, TrackingPose_t target_pose, float step, TrackingPose_t horizon[])
+{
+    // Reference Poses Along the Curve Every step Meters, Hold the Target Without a Curve
+    for(int k = 0; k < MpcController::HORIZON; k++)
+    {
+        if(!path.curve.Empty())
+        {
+            PathSpline::Sample_t sample = path.curve.Sample(path.progress + (k + 1) * step);
+            horizon[k].x = sample.x;
+            horizon[k].y = sample.y;
+            horizon[k].theta = sample.theta;
+        }
+        else
+        {
+            horizon[k] = target_pose;
+        }
+    }
+}
+
+float CurvatureAhead(const TrackingPath_t &path, float distance)
+{
+    // Curvature of the Circle Through Three Consecutive Samples, k = 4 Area / (a b c)
+    static const float STEP = 0.1;
+    static const int   MAX_SAMPLES = 64;
+
+    if(path.curve.Empty())
+    {
+        return 0.0;
+    }
+
+    int samples = std::min((int)(distance / STEP), MAX_SAMPLES);
+    PathSpline::Sample_t p0 = path.curve.Sample(path.progress);
+    PathSpline::Sample_t p1 = path.curve.Sample(path.progress + STEP);
+    float curvature = 0.0;
+
+    for(int k = 2; k <= samples; k++)
+    {
+        PathSpline::Sample_t p2 = path.curve.Sample(path.progress + k * STEP);
+
+        float ax = p1.x - p0.x, ay = p1.y - p0.y;
+        float bx = p2.x - p1.x, by = p2.y - p1.y;
+        float cx = p2.x - p0.x, cy = p2.y - p0.y;
+        float abc = sqrt((ax * ax + ay * ay) * (bx * bx + by * by) * (cx * cx + cy * cy));
+
+        // Samples Collapse at the End of the Curve
+        if(abc > 1e-9)
+        {
+            curvature = std::max(curvature, (float)(2.0 * fabs(ax * by - ay * bx) / abc));
+        }
+        p0 = p1;
+        p1 = p2;
+    }
+    return curvature;
+}
+
+TrackingPose_t GlobalToLocalVel(TrackingPose_t robot_pose, TrackingPose_t global_vel)
+{
+    TrackingPose_t local_vel;
+
+    local_vel.x = global_vel.x * sin(robot_pose.theta) - global_vel.y * cos(robot_pose.theta);
+    local_vel.y = global_vel.x * cos(robot_pose.theta) + global_vel.y * sin(robot_pose.theta);
+    local_vel.theta = global_vel.theta;
+
+    return local_vel;
+}
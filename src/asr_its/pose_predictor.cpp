@@ -0,0 +1,120 @@
+#include "pose_predictor.h"
+
+#include <cmath>
+
+static float WrapAngle(float angle)
+{
+    return atan2(sin(angle), cos(angle));
+}
+
+PosePredictor::PosePredictor(int history_size): history(history_size > 1 ? history_size : 2)
+{
+    Reset();
+}
+
+void PosePredictor::Reset()
+{
+    head = 0;
+    count = 0;
+    corrected = false;
+    correction.x = correction.y = correction.theta = 0.0;
+}
+
+void PosePredictor::AddOdom(double stamp, const Pose_t &odom_pose)
+{
+    // Ring Buffer of Recent Odometry, Newest at head - 1
+    history[head].stamp = stamp;
+    history[head].pose  = odom_pose;
+    head = (head + 1) % history.size();
+    if(count < (int)history.size())
+    {
+        count++;
+    }
+}
+
+void PosePredictor::SetMapPose(double stamp, const Pose_t &map_pose)
+{
+    Pose_t odom_pose;
+    if(!OdomAt(stamp, odom_pose))
+    {
+        return;
+    }
+
+    // map->odom = map->base(t) * inverse(odom->base(t))
+    correction = Compose(map_pose, Inverse(odom_pose));
+    corrected = true;
+}
+
+bool PosePredictor::Predict(Pose_t &map_pose) const
+{
+    if(!corrected || count == 0)
+    {
+        return false;
+    }
+
+    const Stamped_t &latest = history[(head - 1 + history.size()) % history.size()];
+    map_pose = Compose(correction, latest.pose);
+    return true;
+}
+
+bool PosePredictor::OdomAt(double stamp, Pose_t &odom_pose) const
+{
+    if(count == 0)
+    {
+        return false;
+    }
+
+    int size = history.size();
+    const Stamped_t &newest = history[(head - 1 + size) % size];
+    const Stamped_t &oldest = history[(head - count + size) % size];
+
+    // Outside the Buffered Window, Use the Closest End
+    if(stamp >= newest.stamp)
+    {
+        odom_pose = newest.pose;
+        return true;
+    }
+    if(stamp <= oldest.stamp)
+    {
+        odom_pose = oldest.pose;
+        return true;
+    }
+
+    // Walk Back from Newest and Interpolate Between Neighbours
+    for(int i = 1; i < count; i++)
+    {
+        const Stamped_t &after  = history[(head - i + size) % size];
+        const Stamped_t &before = history[(head - i - 1 + size) % size];
+        if(before.stamp <= stamp)
+        {
+            double dt = after.stamp - before.stamp;
+            float  k  = (dt > 1e-9) ? (stamp - before.stamp) / dt : 1.0;
+
+            odom_pose.x = before.pose.x + k * (after.pose.x - before.pose.x);
+            odom_pose.y = before.pose.y + k * (after.pose.y - before.pose.y);
+            odom_pose.theta = WrapAngle(before.pose.theta + k * WrapAngle(after.pose.theta - before.pose.theta));
+            return true;
+        }
+    }
+
+    odom_pose = oldest.pose;
+    return true;
+}
+
+PosePredictor::Pose_t PosePredictor::Compose(const Pose_t &a, const Pose_t &b)
+{
+    Pose_t c;
+    c.x = a.x + cos(a.theta) * b.x - sin(a.theta) * b.y;
+    c.y = a.y + sin(a.theta) * b.x + cos(a.theta) * b.y;
+    c.theta = WrapAngle(a.theta + b.theta);
+    return c;
+}
+
+PosePredictor::Pose_t PosePredictor::Inverse(const Pose_t &a)
+{
+    Pose_t c;
+    c.x = -cos(a.theta) * a.x - sin(a.theta) * a.y;
+    c.y =  sin(a.theta) * a.x - cos(a.theta) * a.y;
+    c.theta = WrapAngle(-a.theta);
+    return c;
+}
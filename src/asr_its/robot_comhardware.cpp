@@ -12,10 +12,52 @@ Comhardware::Comhardware(): RosRate(100) //20
     {
         printf("Port Open\n");
 
-        OdomPub = Nh.advertise<nav_msgs::Odometry>("odom", 50);
-        VelPub  = Nh.advertise<geometry_msgs::Twist>("/robot/local_vel", 50);
+        // Odometry Is Stamped so It Always Changes, Only the Rate Cap Applies
+        ros::NodeHandle Nh_Private("~");
+        double odom_max_rate, vel_max_rate, refresh_period;
+        Nh_Private.param("odom_max_rate", odom_max_rate, 0.0);
+        Nh_Private.param("vel_max_rate", vel_max_rate, 0.0);
+        Nh_Private.param("publish_refresh_period", refresh_period, 0.5);
+
+        OdomPub.Advertise(Nh, "odom", 50, odom_max_rate, refresh_period);
+        VelPub.Advertise (Nh, "/robot/local_vel", 50, vel_max_rate, refresh_period);
         SpeedSub = Nh.subscribe("robot/cmd_vel", 10, &Comhardware::SpeedSubCallback, this);
 
+        // Broadcast odom to base_link Here, Stamped with the Serial Read Like the Odometry
+        Nh_Private.param("publish_tf", publish_tf, false);
+        OdomTf.header.frame_id = "odom";
+        OdomTf.child_frame_id = "base_link";
+        OdomTf.transform.translation.z = 0.0;
+
+        // Stop the Base When robot_node Goes Quiet, Commands and Heartbeats Both Keep It Fresh
+        Nh_Private.param("command_timeout", command_timeout, 0.3);
+        HeartbeatSub = Nh.subscribe("robot/cmd_heartbeat", 1, &Comhardware::HeartbeatCallback, this);
+        last_command_time = ros::Time::now();
+
+        // Command Frame Format, v1 Adds Sequence Numbers, CRC, Fixed-Point Units and Acks
+        std::string command_protocol;
+        CommandLink::Protocol_t protocol;
+        double link_stats_period;
+        Nh_Private.param<std::string>("command_protocol", command_protocol, "legacy");
+        Nh_Private.param("link_stats_period", link_stats_period, 1.0);
+        if (!CommandLink::ParseProtocol(command_protocol, protocol))
+        {
+            ROS_WARN("Unknown command_protocol '%s', using legacy", command_protocol.c_str());
+            protocol = CommandLink::LEGACY;
+        }
+        Link.SetProtocol(protocol);
+        Command = CommandLink::Command_t();
+        ROS_INFO("Command protocol: %s", CommandLink::ProtocolName(protocol));
+
+        LinkStatsPub   = Nh.advertise<main_controller::CommandLinkStats>("robot/command_link", 10);
+        LinkStatsTimer = Nh.createTimer(ros::Duration(link_stats_period), &Comhardware::LinkStatsEvent, this);
+
+        // Latency of Each Command from Its Input Event to the Serial Write, per Stage
+        double latency_period;
+        Nh_Private.param("latency_period", latency_period, 5.0);
+        LatencyPub   = Nh.advertise<main_controller::LatencyHistogram>("robot/command_latency", 10);
+        LatencyTimer = Nh.createTimer(ros::Duration(latency_period), &Comhardware::LatencyEvent, this);
+
         ThreadSerialTransmit = Nh.createTimer(ros::Duration(0.01), &Comhardware::SerialTransmitEvent, this);
         ThreadSerialReceived = Nh.createTimer(ros::Duration(0.01), &Comhardware::SerialReceiveEvent, this);
         Mts.spin();
@@ -26,23 +68,68 @@ Comhardware::~Comhardware(){};
 
 void Comhardware::SerialTransmitEvent(const ros::TimerEvent &event)
 {
-    char data_kirim[11] = {'m', 'r', 'i'};
-    memcpy(data_kirim + 3, &RobotSpeed[0], 2);
-    memcpy(data_kirim + 5, &RobotSpeed[1], 2);
-    memcpy(data_kirim + 7, &RobotSpeed[2], 2);
-    data_kirim[9] = BitLamp;
-    data_kirim[10] = StatusControl;
-    // memcpy(data_kirim + 11, &OffsetPos[0], 4);
-    // memcpy(data_kirim + 15, &OffsetPos[1], 4);
-    // memcpy(data_kirim + 19, &OffsetPos[2], 4);
-
-    RS232_SendBuf(Cport_nr, (unsigned char *)data_kirim, 11);
+    uint8_t frame[CommandLink::MAX_FRAME];
+    int     length;
+    {
+        std::lock_guard<std::mutex> lock(LinkMutex);
+
+        // No Fresh Command Within the Deadline, Send a Stop Frame Until One Arrives
+        if ((ros::Time::now() - last_command_time).toSec() > command_timeout)
+        {
+            if (!deadman_stopped)
+            {
+                ROS_WARN("No command for %.2f s, stopping the base", command_timeout);
+                deadman_stopped = true;
+            }
+            StatusControl = 0;
+            Command.has_accel = false;
+            for (int i = 0; i < 3; i++)
+            {
+                RobotSpeed[i] = 0;
+                Command.velocity[i] = 0.0;
+                Command.accel[i] = 0.0;
+            }
+        }
+
+        Command.lamp = BitLamp;
+        Command.status = StatusControl;
+        length = Link.Encode(Command, ros::Time::now().toSec(), frame);
+    }
+
+    RS232_SendBuf(Cport_nr, frame, length);
+
+    // First Write of a Traced Command Closes Its Trace
+    std::lock_guard<std::mutex> lock(LinkMutex);
+    if (trace_pending)
+    {
+        ros::Time written = ros::Time::now();
+        if (!trace_origin.isZero())
+        {
+            StageLatency[STAGE_INPUT].Add((trace_tick - trace_origin).toSec());
+            StageLatency[STAGE_TOTAL].Add((written - trace_origin).toSec());
+        }
+        StageLatency[STAGE_CONTROLLER].Add((trace_publish - trace_tick).toSec());
+        StageLatency[STAGE_TRANSPORT].Add((trace_receive - trace_publish).toSec());
+        StageLatency[STAGE_SERIAL].Add((written - trace_receive).toSec());
+        trace_pending = false;
+    }
 
 }
 
 void Comhardware::SerialReceiveEvent(const ros::TimerEvent &event)
 {
-    n = RS232_PollComport(Cport_nr, Buf, 4095);
+    // Room for a Held Back Ack Header Coming Back as Text, and the Terminator Below
+    n = RS232_PollComport(Cport_nr, Buf, sizeof(Buf) - CommandLink::MAX_FRAME - 1);
+
+    // Closest Time to the Measurement, Parsing and Filtering Below Must Not Delay the Stamp
+    ros::Time read_time = ros::Time::now();
+
+    // Acks Travel in the Same Stream, Leave Only the Odometry Text
+    if (n > 0 && Link.Protocol() == CommandLink::V1)
+    {
+        std::lock_guard<std::mutex> lock(LinkMutex);
+        n = Link.Extract(Buf, n, sizeof(Buf) - 1, ros::Time::now().toSec());
+    }
     // ROS_INFO("DEBUG 1 n = %d", n);
 
     if (n > 10)
@@ -124,7 +211,7 @@ void Comhardware::SerialReceiveEvent(const ros::TimerEvent &event)
             // printf ("vx = %d | vy = %d | vz = %d | status control = %d | bitlamp = %d \n", RobotSpeed[0], RobotSpeed[1], RobotSpeed[2], StatusControl, BitLamp);
             
 
-            CurrentTime = ros::Time::now();
+            CurrentTime = read_time;
         
             OdomQuat = tf::createQuaternionMsgFromYaw(PositionFiltered[2] * 3.14 / 180);
 
@@ -150,14 +237,23 @@ void Comhardware::SerialReceiveEvent(const ros::TimerEvent &event)
             Odom.twist.twist.angular.z = VelocityFilter[2];
 
             //publish the message
-            OdomPub.publish(Odom);
+            OdomPub.Publish(Odom);
+
+            if (publish_tf)
+            {
+                OdomTf.header.stamp = CurrentTime;
+                OdomTf.transform.translation.x = Odom.pose.pose.position.x;
+                OdomTf.transform.translation.y = Odom.pose.pose.position.y;
+                OdomTf.transform.rotation = OdomQuat;
+                OdomTfBroadcaster.sendTransform(OdomTf);
+            }
             
 
             RobotVel.linear.x = VelocityFilter[0];
             RobotVel.linear.y = VelocityFilter[1];
             RobotVel.angular.z = VelocityFilter[2];
 
-            VelPub.publish(RobotVel);
+            VelPub.Publish(RobotVel);
         }
         if (DataLen == 4 && sLocal[0].length() > 6)
         {
@@ -174,8 +270,121 @@ void Comhardware::SerialReceiveEvent(const ros::TimerEvent &event)
 
 void Comhardware::SpeedSubCallback(const main_controller::ControllerData &msg)
 {
+    std::lock_guard<std::mutex> lock(LinkMutex);
+
+    last_command_time = ros::Time::now();
+    if (deadman_stopped)
+    {
+        ROS_INFO("Commands resumed");
+        deadman_stopped = false;
+    }
+
     StatusControl = msg.StatusControl;
     RobotSpeed[0] = msg.data[0];
     RobotSpeed[1] = msg.data[1];
     RobotSpeed[2] = msg.data[2];
-}
\ No newline at end of file
+
+    // Numbered by robot_node on Every Command It Sends, Including Refreshes; the Heartbeat Names It
+    if (msg.seq != 0)
+    {
+        if (last_command_seq != 0 && msg.seq > last_command_seq + 1)
+        {
+            seq_gaps += msg.seq - last_command_seq - 1;
+        }
+        last_command_seq = msg.seq;
+    }
+
+    // Commands Without a Trace (Older Senders) Are Not Timed
+    if (!msg.tick_stamp.isZero())
+    {
+        trace_pending = true;
+        trace_origin  = msg.header.stamp;
+        trace_tick    = msg.tick_stamp;
+        trace_publish = msg.publish_stamp;
+        trace_receive = ros::Time::now();
+    }
+
+    // Fine Velocity and Feedforward When the Controller Provides Them
+    bool fine = msg.velocity.size() >= 3;
+    Command.has_accel = msg.accel.size() >= 3;
+    for (int i = 0; i < 3; i++)
+    {
+        Command.velocity[i] = fine ? msg.velocity[i] : msg.data[i];
+        Command.accel[i] = Command.has_accel ? msg.accel[i] : 0.0;
+    }
+}
+
+void Comhardware::HeartbeatCallback(const std_msgs::UInt32 &msg)
+{
+    std::lock_guard<std::mutex> lock(LinkMutex);
+
+    // A Heartbeat Only Vouches for the Command It Names, a Missed Command Lets the Deadline Run Out
+    if (!deadman_stopped && msg.data != 0 && msg.data == last_command_seq)
+    {
+        last_command_time = ros::Time::now();
+    }
+}
+
+void Comhardware::LinkStatsEvent(const ros::TimerEvent &event)
+{
+    CommandLink::Stats_t stats;
+    {
+        std::lock_guard<std::mutex> lock(LinkMutex);
+        stats = Link.GetStats(true);
+    }
+
+    MsgLinkStats.header.stamp    = ros::Time::now();
+    MsgLinkStats.protocol        = CommandLink::ProtocolName(Link.Protocol());
+    MsgLinkStats.sent            = stats.sent;
+    MsgLinkStats.acked           = stats.acked;
+    MsgLinkStats.lost            = stats.lost;
+    MsgLinkStats.rejected        = stats.rejected;
+    MsgLinkStats.firmware_missed = stats.firmware_missed;
+    MsgLinkStats.rtt_last        = stats.rtt_last * 1e6;
+    MsgLinkStats.rtt_mean        = stats.rtt_mean * 1e6;
+    MsgLinkStats.rtt_max         = stats.rtt_max * 1e6;
+    LinkStatsPub.publish(MsgLinkStats);
+
+    if (stats.lost > 0)
+    {
+        ROS_WARN("Command link: %lu of %lu commands never acknowledged", (unsigned long)stats.lost, (unsigned long)stats.sent);
+    }
+}
+
+void Comhardware::LatencyEvent(const ros::TimerEvent &event)
+{
+    static const char* stage_names[NUM_STAGES] = {"input", "controller", "transport", "serial", "total"};
+
+    MsgLatency.stage.clear();
+    MsgLatency.bin_edges.clear();
+    MsgLatency.counts.clear();
+    MsgLatency.samples.clear();
+    MsgLatency.mean.clear();
+    MsgLatency.max.clear();
+
+    for (int bin = 0; bin < LatencyHistogram::BINS; bin++)
+    {
+        MsgLatency.bin_edges.push_back(LatencyHistogram::BinEdge(bin));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(LinkMutex);
+        for (int stage = 0; stage < NUM_STAGES; stage++)
+        {
+            MsgLatency.stage.push_back(stage_names[stage]);
+            for (int bin = 0; bin < LatencyHistogram::BINS; bin++)
+            {
+                MsgLatency.counts.push_back(StageLatency[stage].Count(bin));
+            }
+            MsgLatency.samples.push_back(StageLatency[stage].Samples());
+            MsgLatency.mean.push_back(StageLatency[stage].Mean());
+            MsgLatency.max.push_back(StageLatency[stage].Max());
+            StageLatency[stage].Reset();
+        }
+        MsgLatency.seq_gaps = seq_gaps;
+        seq_gaps = 0;
+    }
+
+    MsgLatency.header.stamp = ros::Time::now();
+    LatencyPub.publish(MsgLatency);
+}
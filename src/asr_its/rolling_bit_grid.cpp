@@ -0,0 +1,418 @@
+#include "rolling_bit_grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+const float RollingBitGrid::NO_OCCUPIED = 1e6;
+
+RollingBitGrid::RollingBitGrid(): table_angle_min(0.0), table_increment(0.0)
+{
+    Configure(4.0, 0.05, 0.3);
+}
+
+void RollingBitGrid::Configure(float size, float resolution, float footprint_radius)
+{
+    this->resolution = resolution;
+    width  = std::max(1, (int)ceil(size / resolution));
+    height = width;
+    words  = (width + 63) / 64;
+    origin_x = 0;
+    origin_y = 0;
+    cells.assign(height * words, 0);
+
+    // Cells Whose Centre Lies Within the Radius, Half Width per Row Offset
+    footprint_rows = (int)(footprint_radius / resolution);
+    footprint_half.resize(2 * footprint_rows + 1);
+    for(int dy = -footprint_rows; dy <= footprint_rows; dy++)
+    {
+        float y = dy * resolution;
+        float half = sqrt(std::max(footprint_radius * footprint_radius - y * y, 0.0f));
+        footprint_half[dy + footprint_rows] = (int)(half / resolution);
+    }
+}
+
+void RollingBitGrid::Clear()
+{
+    std::fill(cells.begin(), cells.end(), 0);
+}
+
+void RollingBitGrid::CopyFrom(const RollingBitGrid &other)
+{
+    origin_x = other.origin_x;
+    origin_y = other.origin_y;
+    cells = other.cells;
+}
+
+int RollingBitGrid::Width() const
+{
+    return width;
+}
+
+int RollingBitGrid::Height() const
+{
+    return height;
+}
+
+float RollingBitGrid::Resolution() const
+{
+    return resolution;
+}
+
+int RollingBitGrid::CellIndex(float v) const
+{
+    return (int)floor(v / resolution);
+}
+
+void RollingBitGrid::SetBit(int cx, int cy, bool value)
+{
+    uint64_t &word = cells[cy * words + (cx >> 6)];
+    uint64_t bit = (uint64_t)1 << (cx & 63);
+    word = value ? (word | bit) : (word & ~bit);
+}
+
+bool RollingBitGrid::GetBit(int cx, int cy) const
+{
+    return (cells[cy * words + (cx >> 6)] >> (cx & 63)) & 1;
+}
+
+void RollingBitGrid::Scroll(float x, float y)
+{
+    int new_x = CellIndex(x) - width / 2;
+    int new_y = CellIndex(y) - height / 2;
+    int dx = new_x - origin_x;
+    int dy = new_y - origin_y;
+
+    if(dx == 0 && dy == 0)
+    {
+        return;
+    }
+
+    // Nothing Survives a Jump Larger than the Window
+    if(abs(dx) >= width || abs(dy) >= height)
+    {
+        Clear();
+    }
+    else
+    {
+        ShiftRows(dy);
+        ShiftColumns(dx);
+    }
+    origin_x = new_x;
+    origin_y = new_y;
+}
+
+void RollingBitGrid::ShiftRows(int dy)
+{
+    // Row j Takes Old Row j + dy, Rows Coming into View Start Free
+    uint64_t* data = cells.data();
+    size_t row_bytes = words * sizeof(uint64_t);
+
+    if(dy > 0)
+    {
+        memmove(data, data + dy * words, (height - dy) * row_bytes);
+        memset(data + (height - dy) * words, 0, dy * row_bytes);
+    }
+    else if(dy < 0)
+    {
+        memmove(data - dy * words, data, (height + dy) * row_bytes);
+        memset(data, 0, -dy * row_bytes);
+    }
+}
+
+void RollingBitGrid::ShiftColumns(int dx)
+{
+    if(dx == 0)
+    {
+        return;
+    }
+
+    // Column i Takes Old Column i + dx, a Multi-Word Shift per Row
+    int word_shift = abs(dx) >> 6;
+    int bit_shift  = abs(dx) & 63;
+    uint64_t tail_mask = (width & 63) ? (((uint64_t)1 << (width & 63)) - 1) : ~(uint64_t)0;
+
+    for(int row = 0; row < height; row++)
+    {
+        uint64_t* w = cells.data() + row * words;
+
+        if(dx > 0)
+        {
+            for(int i = 0; i < words; i++)
+            {
+                int src = i + word_shift;
+                uint64_t lo = src < words ? w[src] : 0;
+                uint64_t hi = src + 1 < words ? w[src + 1] : 0;
+                w[i] = bit_shift ? ((lo >> bit_shift) | (hi << (64 - bit_shift))) : lo;
+            }
+        }
+        else
+        {
+            for(int i = words - 1; i >= 0; i--)
+            {
+                int src = i - word_shift;
+                uint64_t hi = src >= 0 ? w[src] : 0;
+                uint64_t lo = src - 1 >= 0 ? w[src - 1] : 0;
+                w[i] = bit_shift ? ((hi << bit_shift) | (lo >> (64 - bit_shift))) : hi;
+            }
+        }
+
+        // Bits Past the Last Column Stay Clear so Right Shifts Bring In Free Cells
+        w[words - 1] &= tail_mask;
+    }
+}
+
+void RollingBitGrid::InsertScan(const Pose_t &laser_pose, float angle_min, float angle_increment,
+                                const float* ranges, int count, float range_min, float range_max)
+{
+    if(count != (int)beam_cos.size() || angle_min != table_angle_min || angle_increment != table_increment)
+    {
+        table_angle_min = angle_min;
+        table_increment = angle_increment;
+        beam_cos.resize(count);
+        beam_sin.resize(count);
+        ray_x.resize(count);
+        ray_y.resize(count);
+        beam_steps.resize(count);
+        step_cell.resize(count);
+        for(int i = 0; i < count; i++)
+        {
+            double angle = angle_min + i * (double)angle_increment;
+            beam_cos[i] = cos(angle);
+            beam_sin[i] = sin(angle);
+        }
+    }
+
+    // Beam Directions in the Odom Frame, Positions in Cells Relative to the Window
+    const float ct = cos(laser_pose.theta);
+    const float st = sin(laser_pose.theta);
+    const float inv_res = 1.0 / resolution;
+    const float lx = laser_pose.x * inv_res - origin_x;
+    const float ly = laser_pose.y * inv_res - origin_y;
+    const float fw = width;
+    const float fh = height;
+    const float* c = beam_cos.data();
+    const float* s = beam_sin.data();
+    float* rx = ray_x.data();
+    float* ry = ray_y.data();
+    float* steps = beam_steps.data();
+    int* cell = step_cell.data();
+    const int row_bits = words * 64;
+
+    // Free Length of Each Beam in Cells. A Return Clears Up to the Cell Before It, No Return
+    // (range_max or Beyond, inf Included) Clears the Whole Beam, Anything Else Leaves the Grid Untouched
+    const float clear_all = range_max * inv_res + 1.0f;
+    float longest = 0.0;
+    #pragma omp simd reduction(max:longest)
+    for(int i = 0; i < count; i++)
+    {
+        float r = ranges[i];
+        bool hit = (r >= range_min) && (r < range_max);
+        bool miss = r >= range_max;
+        rx[i] = c[i] * ct - s[i] * st;
+        ry[i] = c[i] * st + s[i] * ct;
+        steps[i] = hit ? r * inv_res : (miss ? clear_all : -1.0f);
+        longest = std::max(longest, steps[i]);
+    }
+
+    // March All Beams One Cell at a Time, Clearing Up to the Cell Before the Return.
+    // The Window Is Convex, so Once Every Ray Has Left It or Ended There Is Nothing Left to Clear
+    int max_steps = std::min((int)longest, (int)(fw + fh));
+    for(int k = 1; k < max_steps; k++)
+    {
+        const float d = k;
+        int active = 0;
+
+        #pragma omp simd reduction(+:active)
+        for(int i = 0; i < count; i++)
+        {
+            float x = lx + d * rx[i];
+            float y = ly + d * ry[i];
+            bool along = d < steps[i] - 1.0f;
+            bool inside = (x >= 0.0f) && (x < fw) && (y >= 0.0f) && (y < fh);
+            cell[i] = (along && inside) ? (int)y * row_bits + (int)x : -1;
+            active += (along && inside) ? 1 : 0;
+        }
+
+        if(active == 0)
+        {
+            break;
+        }
+
+        for(int i = 0; i < count; i++)
+        {
+            if(cell[i] >= 0)
+            {
+                cells[cell[i] >> 6] &= ~((uint64_t)1 << (cell[i] & 63));
+            }
+        }
+    }
+
+    // Mark Returns Last so a Neighbouring Ray Cannot Clear Them
+    #pragma omp simd
+    for(int i = 0; i < count; i++)
+    {
+        float r = ranges[i];
+        bool hit = (r >= range_min) && (r < range_max);
+        float x = lx + steps[i] * rx[i];
+        float y = ly + steps[i] * ry[i];
+        bool inside = hit && (x >= 0.0f) && (x < fw) && (y >= 0.0f) && (y < fh);
+        cell[i] = inside ? (int)y * row_bits + (int)x : -1;
+    }
+
+    for(int i = 0; i < count; i++)
+    {
+        if(cell[i] >= 0)
+        {
+            cells[cell[i] >> 6] |= (uint64_t)1 << (cell[i] & 63);
+        }
+    }
+}
+
+bool RollingBitGrid::Occupied(float x, float y) const
+{
+    int cx = CellIndex(x) - origin_x;
+    int cy = CellIndex(y) - origin_y;
+
+    if(cx < 0 || cx >= width || cy < 0 || cy >= height)
+    {
+        return false;
+    }
+    return GetBit(cx, cy);
+}
+
+bool RollingBitGrid::RowSpanOccupied(int row, int first, int last) const
+{
+    const uint64_t* w = cells.data() + row * words;
+    int first_word = first >> 6;
+    int last_word  = last >> 6;
+
+    for(int i = first_word; i <= last_word; i++)
+    {
+        uint64_t mask = ~(uint64_t)0;
+        if(i == first_word)
+        {
+            mask &= ~(uint64_t)0 << (first & 63);
+        }
+        if(i == last_word && (last & 63) != 63)
+        {
+            mask &= ((uint64_t)1 << ((last & 63) + 1)) - 1;
+        }
+        if(w[i] & mask)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RollingBitGrid::FootprintFree(float x, float y) const
+{
+    int cx = CellIndex(x) - origin_x;
+    int cy = CellIndex(y) - origin_y;
+
+    for(int dy = -footprint_rows; dy <= footprint_rows; dy++)
+    {
+        int row = cy + dy;
+        if(row < 0 || row >= height)
+        {
+            continue;
+        }
+
+        int half  = footprint_half[dy + footprint_rows];
+        int first = std::max(cx - half, 0);
+        int last  = std::min(cx + half, width - 1);
+        if(first <= last && RowSpanOccupied(row, first, last))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RollingBitGrid::FootprintFree(float x, float y, float from_x, float from_y) const
+{
+    int cx = CellIndex(x) - origin_x;
+    int cy = CellIndex(y) - origin_y;
+    int from_cx = CellIndex(from_x) - origin_x;
+    int from_cy = CellIndex(from_y) - origin_y;
+
+    for(int dy = -footprint_rows; dy <= footprint_rows; dy++)
+    {
+        int row = cy + dy;
+        if(row < 0 || row >= height)
+        {
+            continue;
+        }
+
+        int half  = footprint_half[dy + footprint_rows];
+        int first = std::max(cx - half, 0);
+        int last  = std::min(cx + half, width - 1);
+        if(first > last)
+        {
+            continue;
+        }
+
+        // Only the Parts of the Row Span Outside the Other Footprint Count
+        int from_dy = row - from_cy;
+        if(from_dy < -footprint_rows || from_dy > footprint_rows)
+        {
+            if(RowSpanOccupied(row, first, last))
+            {
+                return false;
+            }
+            continue;
+        }
+
+        int from_half  = footprint_half[from_dy + footprint_rows];
+        int from_first = from_cx - from_half;
+        int from_last  = from_cx + from_half;
+        int left_last   = std::min(last, from_first - 1);
+        int right_first = std::max(first, from_last + 1);
+        if(first <= left_last && RowSpanOccupied(row, first, left_last))
+        {
+            return false;
+        }
+        if(right_first <= last && RowSpanOccupied(row, right_first, last))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+float RollingBitGrid::FootprintClearance(float x, float y) const
+{
+    int cx = CellIndex(x) - origin_x;
+    int cy = CellIndex(y) - origin_y;
+    float clearance = NO_OCCUPIED;
+
+    for(int dy = -footprint_rows; dy <= footprint_rows; dy++)
+    {
+        int row = cy + dy;
+        if(row < 0 || row >= height)
+        {
+            continue;
+        }
+
+        int half  = footprint_half[dy + footprint_rows];
+        int first = std::max(cx - half, 0);
+        int last  = std::min(cx + half, width - 1);
+        if(first > last || !RowSpanOccupied(row, first, last))
+        {
+            continue;
+        }
+
+        // Occupied Rows are Rare, Walk Their Cells One by One
+        float cell_y = (origin_y + row + 0.5f) * resolution - y;
+        for(int col = first; col <= last; col++)
+        {
+            if(GetBit(col, row))
+            {
+                float cell_x = (origin_x + col + 0.5f) * resolution - x;
+                clearance = std::min(clearance, (float)sqrt(cell_x * cell_x + cell_y * cell_y));
+            }
+        }
+    }
+    return clearance;
+}
@@ -0,0 +1,133 @@
+#include "scan_collision.h"
+
+#include <algorithm>
+#include <cmath>
+
+const float ScanCollisionChecker::NO_COLLISION = 1e6;
+
+// Parked Points Never Intersect a Footprint Moving at Robot Speeds
+static const float FAR_AWAY = 1e4;
+
+ScanCollisionChecker::ScanCollisionChecker(): table_angle_min(0.0), table_increment(0.0), valid_count(0)
+{
+    Config_t config;
+    config.laser_x      = 0.12;
+    config.laser_y      = 0.0;
+    config.laser_yaw    = 0.0;
+    config.robot_radius = 0.3;
+    config.self_radius  = 0.0;
+    config.stop_time    = 0.3;
+    config.slow_time    = 1.5;
+    Configure(config);
+}
+
+void ScanCollisionChecker::Configure(const Config_t &config)
+{
+    Config = config;
+
+    // Force New Tables, the Laser Yaw Is Folded into Them
+    beam_cos.clear();
+    beam_sin.clear();
+}
+
+void ScanCollisionChecker::BuildTables(float angle_min, float angle_increment, int count)
+{
+    table_angle_min = angle_min;
+    table_increment = angle_increment;
+    beam_cos.resize(count);
+    beam_sin.resize(count);
+    point_x.resize(count);
+    point_y.resize(count);
+
+    for(int i = 0; i < count; i++)
+    {
+        double angle = Config.laser_yaw + angle_min + i * (double)angle_increment;
+        beam_cos[i] = cos(angle);
+        beam_sin[i] = sin(angle);
+    }
+}
+
+void ScanCollisionChecker::Update(float angle_min, float angle_increment, const float* ranges, int count,
+                                  float range_min, float range_max)
+{
+    if(count != (int)beam_cos.size() || angle_min != table_angle_min || angle_increment != table_increment)
+    {
+        BuildTables(angle_min, angle_increment, count);
+    }
+
+    const float ox = Config.laser_x;
+    const float oy = Config.laser_y;
+    const float self2 = Config.self_radius * Config.self_radius;
+    const float* c = beam_cos.data();
+    const float* s = beam_sin.data();
+    float* px = point_x.data();
+    float* py = point_y.data();
+    int valid = 0;
+
+    #pragma omp simd reduction(+:valid)
+    for(int i = 0; i < count; i++)
+    {
+        float r = ranges[i];
+        float x = ox + r * c[i];
+        float y = oy + r * s[i];
+
+        // NaN and Inf Fail Both Comparisons
+        bool ok = (r >= range_min) && (r <= range_max) && (x * x + y * y >= self2);
+        px[i] = ok ? x : FAR_AWAY;
+        py[i] = ok ? y : FAR_AWAY;
+        valid += ok ? 1 : 0;
+    }
+    valid_count = valid;
+}
+
+bool ScanCollisionChecker::Empty() const
+{
+    return valid_count == 0;
+}
+
+float ScanCollisionChecker::TimeToCollision(float vx, float vy) const
+{
+    const float v2 = vx * vx + vy * vy;
+    if(v2 < 1e-8 || valid_count == 0)
+    {
+        return NO_COLLISION;
+    }
+
+    // Point p Reaches the Footprint When |p - v t| = R: v2 t^2 - 2 b t + c = 0
+    const float inv_v2 = 1.0 / v2;
+    const float r2 = Config.robot_radius * Config.robot_radius;
+    const float* px = point_x.data();
+    const float* py = point_y.data();
+    const int count = point_x.size();
+    float best = NO_COLLISION;
+
+    #pragma omp simd reduction(min:best)
+    for(int i = 0; i < count; i++)
+    {
+        float b = px[i] * vx + py[i] * vy;
+        float c = px[i] * px[i] + py[i] * py[i] - r2;
+        float disc = b * b - v2 * c;
+        float t = (b - sqrtf(std::max(disc, 0.0f))) * inv_v2;
+
+        // Approaching and on a Crossing Line, Already Inside Counts as Now
+        bool hit = (b > 0.0f) && (disc >= 0.0f);
+        t = hit ? std::max(t, 0.0f) : NO_COLLISION;
+        best = std::min(best, t);
+    }
+    return best;
+}
+
+float ScanCollisionChecker::SpeedScale(float vx, float vy, float &time_to_collision) const
+{
+    time_to_collision = TimeToCollision(vx, vy);
+
+    if(time_to_collision <= Config.stop_time)
+    {
+        return 0.0;
+    }
+    if(time_to_collision >= Config.slow_time)
+    {
+        return 1.0;
+    }
+    return (time_to_collision - Config.stop_time) / (Config.slow_time - Config.stop_time);
+}
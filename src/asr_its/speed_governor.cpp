@@ -0,0 +1,52 @@
+#include "speed_governor.h"
+
+#include <algorithm>
+#include <cmath>
+
+SpeedGovernor::SpeedGovernor()
+{
+    Config_t config;
+    config.min_speed            = 10.0;
+    config.max_speed            = 60.0;
+    config.slow_clearance       = 0.5;
+    config.free_clearance       = 2.0;
+    config.max_lateral_accel    = 0.3;
+    config.curvature_lookahead  = 1.0;
+    config.good_position_std    = 0.05;
+    config.bad_position_std     = 0.3;
+    Configure(config);
+}
+
+void SpeedGovernor::Configure(const Config_t &config)
+{
+    Settings = config;
+}
+
+const SpeedGovernor::Config_t& SpeedGovernor::Config() const
+{
+    return Settings;
+}
+
+float SpeedGovernor::Ramp(float value, float tight, float relaxed) const
+{
+    // Fraction of the Way from the Tight to the Relaxed Threshold, Either Direction
+    float t = (value - tight) / (relaxed - tight);
+    t = std::min(std::max(t, 0.0f), 1.0f);
+    return Settings.min_speed + t * (Settings.max_speed - Settings.min_speed);
+}
+
+float SpeedGovernor::Limit(float clearance, float curvature, float position_std) const
+{
+    float limit = Settings.max_speed;
+
+    limit = std::min(limit, Ramp(clearance, Settings.slow_clearance, Settings.free_clearance));
+    limit = std::min(limit, Ramp(position_std, Settings.bad_position_std, Settings.good_position_std));
+
+    // Speed Whose Lateral Acceleration on the Sharpest Turn Stays Within the Limit
+    if(curvature > 1e-3)
+    {
+        float turn_speed = 100.0 * sqrt(Settings.max_lateral_accel / curvature);
+        limit = std::min(limit, std::max(turn_speed, Settings.min_speed));
+    }
+    return limit;
+}
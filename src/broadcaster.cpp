@@ -18,7 +18,7 @@ void callback(const nav_msgs::Odometry::ConstPtr& msg)
     q.setZ(msg->pose.pose.orientation.z);
     transform.setRotation(q);
     
-    br.sendTransform(tf::StampedTransform(transform, ros::Time::now(), "odom", "base_link"));
+    br.sendTransform(tf::StampedTransform(transform, msg->header.stamp, "odom", "base_link"));
 
 }
 
@@ -5,6 +5,7 @@
 #include "std_msgs/MultiArrayLayout.h"
 #include "std_msgs/MultiArrayDimension.h"
 #include "std_msgs/Int16MultiArray.h"
+#include "sensor_msgs/Joy.h"
 
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -21,18 +22,137 @@
 // Copyright Drew Noakes 2013-2016
 
 #include "joystick.hh"
+#include "joystick_evdev.hh"
+#include <algorithm>
+#include <cmath>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
 #include <unistd.h>
 
 int a = 0b00000000000;
-unsigned char b = 0;
-unsigned char c = 0;
-//int b = 0b00000000;
-
 
 ros::Publisher pub_button;
 ros::Publisher pub_axis;
+ros::Publisher pub_joy;
 std_msgs::Int32 msg_button;
 std_msgs::Int16MultiArray msg_axis;
+sensor_msgs::Joy msg_joy;
+
+// The js API time is in milliseconds on an unspecified clock, take the read time
+static ros::Time EventStamp(const JoystickEvent &event)
+{
+  return ros::Time::now();
+}
+
+static ros::Time EventStamp(const JoystickEvdevEvent &event)
+{
+  ros::Time stamp;
+  stamp.fromNSec(event.timeMicros * 1000);
+  return stamp;
+}
+
+// Wait on the device, drain every queued event into one state and publish it at most
+// max_rate times per second. controller/joy carries the stamp of the newest event.
+// An unchanged state is republished every refresh_period, so a lost message (the final
+// zero of a released stick in particular) is corrected within one period.
+template <class Device, class Event>
+static int RunReader(Device &joystick, const std::string &device, ros::WallDuration min_interval,
+                     ros::WallDuration refresh_period)
+{
+  struct pollfd joystick_poll;
+  joystick_poll.fd = joystick.fileDescriptor();
+  joystick_poll.events = POLLIN;
+
+  bool button_changed = false;
+  bool axis_changed = false;
+  bool joy_changed = false;
+  ros::WallTime last_publish;
+
+  while (ros::ok())
+  {
+    // Sleep until the device has events, or until a held back state may go out
+    int timeout_ms = 100;
+    if (joy_changed || !refresh_period.isZero())
+    {
+      double wait = (last_publish + (joy_changed ? min_interval : refresh_period) - ros::WallTime::now()).toSec();
+      timeout_ms = std::min(timeout_ms, std::max(0, (int)ceil(wait * 1000.0)));
+    }
+
+    int ready = poll(&joystick_poll, 1, timeout_ms);
+    if (ready < 0 && errno != EINTR)
+    {
+      ROS_ERROR("Joystick poll failed: %s", strerror(errno));
+      return 1;
+    }
+    if (joystick_poll.revents & (POLLERR | POLLHUP | POLLNVAL))
+    {
+      ROS_ERROR("Joystick %s disconnected", device.c_str());
+      return 1;
+    }
+
+    // Drain everything queued since the last wakeup into one state
+    Event event;
+    while (joystick.sample(&event))
+    {
+      msg_joy.header.stamp = EventStamp(event);
+      joy_changed = true;
+
+      if (event.isButton())
+      {
+        a=(1 << event.number)^(a);
+        button_changed = true;
+        ROS_DEBUG("Button %u is %s", event.number, event.value == 0 ? "press" : "release");
+
+        if (msg_joy.buttons.size() <= event.number)
+          msg_joy.buttons.resize(event.number + 1, 0);
+        msg_joy.buttons[event.number] = event.value;
+      }
+      else if (event.isAxis())
+      {
+        if (msg_joy.axes.size() <= event.number)
+          msg_joy.axes.resize(event.number + 1, 0.0);
+        msg_joy.axes[event.number] = (float)event.value / JoystickEvent::MAX_AXES_VALUE;
+
+        if (event.number <= 3 && msg_axis.data.at(event.number) != event.value) //axis 4-5 di skip supaya hemat data
+        {
+          msg_axis.data.at(event.number)=event.value;
+          axis_changed = true;
+        }
+      }
+    }
+
+    ros::WallTime now = ros::WallTime::now();
+    if (joy_changed && now - last_publish >= min_interval)
+    {
+      if (button_changed)
+      {
+        msg_button.data=a;
+        pub_button.publish(msg_button);
+      }
+      if (axis_changed)
+      {
+        pub_axis.publish(msg_axis);
+      }
+      pub_joy.publish(msg_joy);
+
+      button_changed = false;
+      axis_changed = false;
+      joy_changed = false;
+      last_publish = now;
+    }
+    else if (!joy_changed && !refresh_period.isZero() && now - last_publish >= refresh_period)
+    {
+      // Nothing changed, the same state again as the heartbeat of the joystick
+      pub_axis.publish(msg_axis);
+      pub_joy.publish(msg_joy);
+      last_publish = now;
+    }
+
+    ros::spinOnce();
+  }
+  return 0;
+}
 
 
 int main(int argc, char** argv)
@@ -41,31 +161,44 @@ int main(int argc, char** argv)
   ros::init(argc, argv, "controller");
 
   ros::NodeHandle nh;
-  ros::Rate rosRate(200);
+  ros::NodeHandle nh_private("~");
+
+  // Events are coalesced per wakeup, max_rate caps how often a changed state goes out.
+  // backend js reads /dev/input/jsX, evdev reads /dev/input/event* with kernel timestamps
+  std::string backend, device;
+  double max_rate, refresh_period;
+  nh_private.param<std::string>("backend", backend, "js");
+  nh_private.param<std::string>("device", device, backend == "evdev" ? "/dev/input/event0" : "/dev/input/js0");
+  nh_private.param("max_rate", max_rate, 100.0);
+  nh_private.param("refresh_period", refresh_period, 0.2);
+  ros::WallDuration min_interval(max_rate > 0.0 ? 1.0 / max_rate : 0.0);
 
   pub_button = nh.advertise<std_msgs::Int32>("controller/button",17);
   pub_axis = nh.advertise<std_msgs::Int16MultiArray>("controller/axis", 6);
+  pub_joy = nh.advertise<sensor_msgs::Joy>("controller/joy", 10);
   msg_button.data=0;
   msg_axis.data.clear();
-  // msg_axis.data[0]=123;
-  // msg_axis.data[1]=230;
-  // msg_axis.data[2]=905;
-  // msg_axis.data[3]=322;
-  // msg_axis.data[4]=888;
-  // msg_axis.data[5]=111;
-
 
 		//for loop, pushing data in the size of the array
 		for (int i = 0; i < 4; i++)
 		{
-			//assign array a random number between 0 and 255.
 			msg_axis.data.push_back(0);
     }
 
-//  printf ("%d\n",a);
-//  printf ("%d\n",1<<3);
+  if (backend == "evdev")
+  {
+    JoystickEvdev joystick(device);
+    if (!joystick.isFound())
+    {
+      printf("open failed.\n");
+      exit(1);
+    }
+    ROS_INFO("Joystick %s (evdev): %d buttons, %d axes", device.c_str(), joystick.buttonCount(), joystick.axisCount());
+    return RunReader<JoystickEvdev, JoystickEvdevEvent>(joystick, device, min_interval, ros::WallDuration(std::max(0.0, refresh_period)));
+  }
+
   // Create an instance of Joystick
-  Joystick joystick("/dev/input/js0");
+  Joystick joystick(device);
 
   // Ensure that it was found and that we can use it
   if (!joystick.isFound())
@@ -73,54 +206,5 @@ int main(int argc, char** argv)
     printf("open failed.\n");
     exit(1);
   }
-
-  while (ros::ok())
-  {
-    // Restrict rate
-    usleep(1000);
-
-    // Attempt to sample an event from the joystick
-    JoystickEvent event;
-    if (joystick.sample(&event))
-    {
-      if (event.isButton())
-      {
-        printf("Button %u is %s\n",
-          event.number,
-          event.value == 0 ? "press" : "release");
-
-          a=(1 << event.number)^(a);
-          // printf("%d              ",a);
-          // printf("%d , %d \n", event.number, event.value);
-
-          msg_button.data=a;
-          pub_button.publish(msg_button);
-      }
-      else if (event.isAxis())
-      {
-         if (event.number <= 3) //axis 4-5 di skip supaya hemat data
-         {
-          msg_axis.data.at(event.number)=event.value;
-          pub_axis.publish(msg_axis);
-          if (msg_axis.data.at(event.number)==0) //kalau nilainya 0 langsung di spam 0 3 kali biar aman
-          {
-            for (int i=0; i<2; i++)
-            {
-              pub_axis.publish(msg_axis);
-              printf("000 Axis %u is at position %d\n", event.number, event.value);
-            }
-          }
-          printf("Axis %u is at position %d\n", event.number, event.value);
-         }
-      }
-    }
-
-
-    // msg_button.data=a;
-    // pub_button.publish(msg_button);
-
-    ros::spinOnce();
-    ros::Duration(0.001).sleep();
-  }
-  return 0; 
+  return RunReader<Joystick, JoystickEvent>(joystick, device, min_interval, ros::WallDuration(std::max(0.0, refresh_period)));
 }
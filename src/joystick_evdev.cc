@@ -0,0 +1,186 @@
+#include "joystick_evdev.hh"
+
+#include <fcntl.h>
+#include <linux/input.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#define BITS_PER_LONG       (sizeof(long) * 8)
+#define NBITS(x)            ((((x) - 1) / BITS_PER_LONG) + 1)
+#define TEST_BIT(bit, array) ((array[(bit) / BITS_PER_LONG] >> ((bit) % BITS_PER_LONG)) & 1)
+
+JoystickEvdev::JoystickEvdev(std::string devicePath, bool blocking)
+{
+  openPath(devicePath, blocking);
+}
+
+void JoystickEvdev::openPath(std::string devicePath, bool blocking)
+{
+  _buttonCount = 0;
+  _axisCount = 0;
+  for (int i = 0; i < 0x300; i++)
+    _buttonNumber[i] = -1;
+  for (int i = 0; i < 0x40; i++)
+    _axisNumber[i] = -1;
+
+  _fd = open(devicePath.c_str(), blocking ? O_RDONLY : O_RDONLY | O_NONBLOCK);
+  if (_fd < 0)
+    return;
+
+  // Kernel timestamps on the same clock as ros::Time::now()
+  int clock = CLOCK_REALTIME;
+  ioctl(_fd, EVIOCSCLOCKID, &clock);
+
+  unsigned long keyBits[NBITS(KEY_MAX + 1)];
+  unsigned long absBits[NBITS(ABS_MAX + 1)];
+  memset(keyBits, 0, sizeof(keyBits));
+  memset(absBits, 0, sizeof(absBits));
+  ioctl(_fd, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits);
+  ioctl(_fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits);
+
+  // Same order as joydev: BTN_JOYSTICK up to KEY_MAX, then BTN_MISC up to BTN_JOYSTICK
+  for (int code = BTN_JOYSTICK; code < 0x300 && code <= KEY_MAX; code++)
+    if (TEST_BIT(code, keyBits))
+      _buttonNumber[code] = _buttonCount++;
+  for (int code = BTN_MISC; code < BTN_JOYSTICK; code++)
+    if (TEST_BIT(code, keyBits))
+      _buttonNumber[code] = _buttonCount++;
+
+  for (int code = 0; code < 0x40 && code <= ABS_MAX; code++)
+  {
+    if (!TEST_BIT(code, absBits))
+      continue;
+
+    struct input_absinfo info;
+    if (ioctl(_fd, EVIOCGABS(code), &info) < 0)
+      continue;
+
+    _axisNumber[code] = _axisCount++;
+    _axisMin[code] = info.minimum;
+    _axisMax[code] = info.maximum;
+    _axisFlat[code] = info.flat;
+  }
+
+  queueInitialState();
+}
+
+void JoystickEvdev::queueInitialState()
+{
+  unsigned long keyState[NBITS(KEY_MAX + 1)];
+  memset(keyState, 0, sizeof(keyState));
+  ioctl(_fd, EVIOCGKEY(sizeof(keyState)), keyState);
+
+  struct timeval now;
+  gettimeofday(&now, NULL);
+
+  JoystickEvdevEvent event;
+  event.timeMicros = (uint64_t)now.tv_sec * 1000000 + now.tv_usec;
+  event.time = event.timeMicros / 1000;
+
+  for (int code = 0; code < 0x300; code++)
+  {
+    if (_buttonNumber[code] < 0)
+      continue;
+    event.type = JS_EVENT_BUTTON | JS_EVENT_INIT;
+    event.number = _buttonNumber[code];
+    event.value = TEST_BIT(code, keyState);
+    _initial.push_back(event);
+  }
+
+  for (int code = 0; code < 0x40; code++)
+  {
+    struct input_absinfo info;
+    if (_axisNumber[code] < 0 || ioctl(_fd, EVIOCGABS(code), &info) < 0)
+      continue;
+    event.type = JS_EVENT_AXIS | JS_EVENT_INIT;
+    event.number = _axisNumber[code];
+    event.value = scaleAxis(code, info.value);
+    _initial.push_back(event);
+  }
+}
+
+short JoystickEvdev::scaleAxis(int code, int value) const
+{
+  int min = _axisMin[code];
+  int max = _axisMax[code];
+  if (max <= min)
+    return 0;
+
+  // Dead zone around the centre, then the full range onto -32767..32767
+  double centre = 0.5 * (min + max);
+  double offset = value - centre;
+  if (offset >= -_axisFlat[code] && offset <= _axisFlat[code])
+    return 0;
+
+  double scaled = offset / (0.5 * (max - min)) * JoystickEvent::MAX_AXES_VALUE;
+  if (scaled > JoystickEvent::MAX_AXES_VALUE)
+    scaled = JoystickEvent::MAX_AXES_VALUE;
+  if (scaled < -JoystickEvent::MAX_AXES_VALUE)
+    scaled = -JoystickEvent::MAX_AXES_VALUE;
+  return (short)scaled;
+}
+
+bool JoystickEvdev::sample(JoystickEvdevEvent* event)
+{
+  if (!_initial.empty())
+  {
+    *event = _initial.front();
+    _initial.pop_front();
+    return true;
+  }
+
+  // Skip synchronisation and other event types until a button or axis change
+  struct input_event input;
+  while (read(_fd, &input, sizeof(input)) == sizeof(input))
+  {
+    if (input.type == EV_KEY && input.code < 0x300 && _buttonNumber[input.code] >= 0 && input.value != 2)
+    {
+      event->type = JS_EVENT_BUTTON;
+      event->number = _buttonNumber[input.code];
+      event->value = input.value;
+    }
+    else if (input.type == EV_ABS && input.code < 0x40 && _axisNumber[input.code] >= 0)
+    {
+      event->type = JS_EVENT_AXIS;
+      event->number = _axisNumber[input.code];
+      event->value = scaleAxis(input.code, input.value);
+    }
+    else
+    {
+      continue;
+    }
+
+    event->timeMicros = (uint64_t)input.time.tv_sec * 1000000 + input.time.tv_usec;
+    event->time = event->timeMicros / 1000;
+    return true;
+  }
+  return false;
+}
+
+bool JoystickEvdev::isFound()
+{
+  return _fd >= 0 && (_buttonCount > 0 || _axisCount > 0);
+}
+
+int JoystickEvdev::fileDescriptor() const
+{
+  return _fd;
+}
+
+int JoystickEvdev::buttonCount() const
+{
+  return _buttonCount;
+}
+
+int JoystickEvdev::axisCount() const
+{
+  return _axisCount;
+}
+
+JoystickEvdev::~JoystickEvdev()
+{
+  if (_fd >= 0)
+    close(_fd);
+}
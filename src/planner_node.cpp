@@ -0,0 +1,349 @@
+#include <ros/ros.h>
+#include <tf/transform_broadcaster.h>
+#include <nav_msgs/Path.h>
+#include <geometry_msgs/PoseStamped.h>
+#include <geometry_msgs/PoseWithCovarianceStamped.h>
+#include <sensor_msgs/LaserScan.h>
+#include <std_msgs/Bool.h>
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "distance_field.h"
+#include "dstar_lite.h"
+#include "grid_planner.h"
+#include "map_file.h"
+#include "occupancy_map.h"
+
+// Plans /path from the latest /amcl_pose to each goal on /goal (the return-to-home of robot_node)
+// or /move_base_simple/goal (rviz) over a stored map. The map is a map_server YAML, with its
+// distance field cached beside it, or a .bmap file from map_convert.
+//
+// With ~replan, a D* Lite search toward the same goal is kept after each plan. When /crashed
+// or /obstacle_detected rises, the points of the latest /scan are added to it as obstacles and
+// only the affected part of the search is repaired before a new /path goes out. The search is
+// dropped when the robot gets within ~goal_tolerance of the goal, or when /path is cleared or
+// replaced by another node, so no path to an old goal goes out later.
+class PlannerNode
+{
+public:
+    PlannerNode()
+    {
+        ros::NodeHandle Nh_Private("~");
+
+        std::string map_file, algorithm;
+        GridPlanner::Config_t config = Planner.Config();
+        Nh_Private.param<std::string>("map_file", map_file, "");
+        Nh_Private.param<std::string>("algorithm", algorithm, "jps");
+        Nh_Private.param<std::string>("frame_id", FrameId, "map");
+        Nh_Private.param("inflation_radius", config.inflation_radius, config.inflation_radius);
+        Nh_Private.param("snap_distance", config.snap_distance, config.snap_distance);
+        Nh_Private.param("replan", replan, true);
+        Nh_Private.param("replan_min_interval", replan_min_interval, 0.5);
+        Nh_Private.param("goal_tolerance", goal_tolerance, 0.3f);
+        Nh_Private.param("obstacle_range", obstacle_range, 3.0f);
+        Nh_Private.param("laser_offset_x", laser_x, 0.12f);
+        Nh_Private.param("laser_offset_y", laser_y, 0.0f);
+        Nh_Private.param("laser_yaw", laser_yaw, 0.0f);
+        if (!GridPlanner::ParseAlgorithm(algorithm, config.algorithm))
+        {
+            ROS_WARN("Unknown planner algorithm '%s', using jps", algorithm.c_str());
+            config.algorithm = GridPlanner::JPS;
+        }
+        Planner.Configure(config);
+
+        if (!LoadMap(map_file))
+        {
+            ros::shutdown();
+            return;
+        }
+        ROS_INFO("Planner %s on %s, %dx%d cells, inflation %.2f m", GridPlanner::AlgorithmName(config.algorithm),
+                 map_file.c_str(), Planner.Width(), Planner.Height(), config.inflation_radius);
+
+        PathPub     = Nh.advertise<nav_msgs::Path>("/path", 1);
+        GoalSub     = Nh.subscribe("/goal", 1, &PlannerNode::GoalCallback, this);
+        RvizGoalSub = Nh.subscribe("/move_base_simple/goal", 1, &PlannerNode::GoalCallback, this);
+        PoseSub     = Nh.subscribe("/amcl_pose", 1, &PlannerNode::PoseCallback, this);
+        if (replan)
+        {
+            ScanSub     = Nh.subscribe("/scan", 1, &PlannerNode::ScanCallback, this);
+            CrashedSub  = Nh.subscribe("/crashed", 1, &PlannerNode::CrashedCallback, this);
+            ObstacleSub = Nh.subscribe("/obstacle_detected", 1, &PlannerNode::ObstacleCallback, this);
+            PathSub     = Nh.subscribe("/path", 1, &PlannerNode::PathCallback, this);
+        }
+
+        ros::spin();
+    }
+
+private:
+    ros::NodeHandle     Nh;
+    ros::Publisher      PathPub;
+    ros::Subscriber     GoalSub;
+    ros::Subscriber     RvizGoalSub;
+    ros::Subscriber     PoseSub;
+    ros::Subscriber     ScanSub;
+    ros::Subscriber     CrashedSub;
+    ros::Subscriber     ObstacleSub;
+    ros::Subscriber     PathSub;
+
+    GridPlanner         Planner;
+    std::string         FrameId;
+    bool                has_pose = false;
+    float               pose_x;
+    float               pose_y;
+    float               pose_yaw;
+
+    // Incremental Replanning
+    DStarLite           DStar;
+    bool                replan;
+    double              replan_min_interval;
+    float               goal_tolerance;
+    float               obstacle_range;
+    float               laser_x;
+    float               laser_y;
+    float               laser_yaw;
+    bool                crashed = false;
+    bool                obstacle = false;
+    ros::Time           last_replan;
+    geometry_msgs::PoseStamped          GoalMsg;
+    sensor_msgs::LaserScan::ConstPtr    LastScan;
+
+    std::vector<GridPlanner::Point_t>   Waypoints;
+    std::vector<GridPlanner::Point_t>   ScanPoints;
+    std::vector<int>                    Cells;
+    nav_msgs::Path                      PathMsg;
+
+    bool LoadMap(const std::string &map_file)
+    {
+        std::string error;
+        if (map_file.size() > 5 && map_file.compare(map_file.size() - 5, 5, ".bmap") == 0)
+        {
+            // Only Needed While Copying the Distance Field, the Pages Are Shared Meanwhile
+            MapFile file;
+            if (!file.Open(map_file, error))
+            {
+                ROS_ERROR("Planner map: %s", error.c_str());
+                return false;
+            }
+            Planner.SetMap(file);
+            return true;
+        }
+
+        OccupancyMap map;
+        DistanceField field;
+        bool from_cache;
+        if (!map.Load(map_file, error))
+        {
+            ROS_ERROR("Planner map: %s", error.c_str());
+            return false;
+        }
+        if (!field.LoadOrCompute(map, DistanceField::CachePath(map_file), true, 0, from_cache))
+        {
+            ROS_WARN("Cannot write the distance cache of %s", map_file.c_str());
+        }
+        Planner.SetMap(field);
+        return true;
+    }
+
+    void PoseCallback(const geometry_msgs::PoseWithCovarianceStamped &msg)
+    {
+        pose_x = msg.pose.pose.position.x;
+        pose_y = msg.pose.pose.position.y;
+        pose_yaw = tf::getYaw(msg.pose.pose.orientation);
+        has_pose = true;
+
+        // Arrived, Later Crashes or Obstacles Must Not Send the Robot Back to This Goal
+        if (DStar.Active() && hypot(pose_x - GoalMsg.pose.position.x, pose_y - GoalMsg.pose.position.y) < goal_tolerance)
+        {
+            DStar.Stop();
+            ROS_INFO("Goal reached, replanning stopped");
+        }
+    }
+
+    void PathCallback(const nav_msgs::Path &msg)
+    {
+        // Our Own Paths Come Back with the Same Stamp, Anything Else Cleared or Replaced Ours
+        if (DStar.Active() && (msg.poses.empty() || msg.header.stamp != PathMsg.header.stamp))
+        {
+            DStar.Stop();
+            ROS_INFO("Path %s, replanning stopped", msg.poses.empty() ? "cleared" : "replaced");
+        }
+    }
+
+    void ScanCallback(const sensor_msgs::LaserScan::ConstPtr &msg)
+    {
+        LastScan = msg;
+    }
+
+    void CrashedCallback(const std_msgs::Bool &msg)
+    {
+        if (msg.data && !crashed)
+        {
+            Replan("crash");
+        }
+        crashed = msg.data;
+    }
+
+    void ObstacleCallback(const std_msgs::Bool &msg)
+    {
+        if (msg.data && !obstacle)
+        {
+            Replan("obstacle");
+        }
+        obstacle = msg.data;
+    }
+
+    void GoalCallback(const geometry_msgs::PoseStamped &msg)
+    {
+        if (!has_pose)
+        {
+            ROS_WARN("Goal ignored, no /amcl_pose yet");
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool found = Planner.Plan(pose_x, pose_y, msg.pose.position.x, msg.pose.position.y, Waypoints);
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        const GridPlanner::Stats_t &stats = Planner.Stats();
+        if (!found)
+        {
+            ROS_WARN("No path to (%.2f, %.2f), %d nodes expanded in %.2f ms", msg.pose.position.x,
+                     msg.pose.position.y, stats.expanded, elapsed);
+            if (replan)
+            {
+                // No Repairs Toward the Previous Goal Once a New One Was Asked For
+                DStar.Stop();
+            }
+            return;
+        }
+
+        GoalMsg = msg;
+        PublishPath();
+
+        ROS_INFO("Path of %zu poses, %.2f m, %d nodes expanded in %.2f ms%s%s", Waypoints.size(), stats.length,
+                 stats.expanded, elapsed, stats.start_snapped ? ", start moved off the inflation" : "",
+                 stats.goal_snapped ? ", goal moved off the inflation" : "");
+
+        if (replan)
+        {
+            // Search Tree for Later Repairs, Built After the Path Went Out; the Waypoints Hold the
+            // Snapped Start Cell Second and End in the Goal Cell Either Way
+            int sx, sy, gx, gy;
+            const GridPlanner::Point_t &start_point = Waypoints[stats.start_snapped ? 1 : 0];
+            Planner.WorldToCell(start_point.x, start_point.y, sx, sy);
+            Planner.WorldToCell(Waypoints.back().x, Waypoints.back().y, gx, gy);
+            DStar.SetMap(Planner);
+            DStar.Start(sy * Planner.Width() + sx, gy * Planner.Width() + gx);
+        }
+    }
+
+    // Points of the Latest Scan in the Map Frame Through the Localised Pose, Within obstacle_range
+    void ProjectScan()
+    {
+        ScanPoints.clear();
+        float c = cos(pose_yaw), s = sin(pose_yaw);
+        float laser_px = pose_x + laser_x * c - laser_y * s;
+        float laser_py = pose_y + laser_x * s + laser_y * c;
+        float angle = pose_yaw + laser_yaw + LastScan->angle_min;
+        for (size_t i = 0; i < LastScan->ranges.size(); i++, angle += LastScan->angle_increment)
+        {
+            float range = LastScan->ranges[i];
+            if (!(range >= LastScan->range_min && range <= LastScan->range_max && range <= obstacle_range))
+            {
+                continue;
+            }
+            GridPlanner::Point_t point = {laser_px + range * (float)cos(angle), laser_py + range * (float)sin(angle)};
+            ScanPoints.push_back(point);
+        }
+    }
+
+    void Replan(const char* reason)
+    {
+        // Only While a Goal Is Outstanding
+        ros::Time now = ros::Time::now();
+        if (!DStar.Active() || !LastScan || !has_pose || (now - last_replan).toSec() < replan_min_interval)
+        {
+            return;
+        }
+        last_replan = now;
+
+        int cx, cy;
+        if (!Planner.WorldToCell(pose_x, pose_y, cx, cy))
+        {
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        ProjectScan();
+        if (!DStar.AddObstacles(ScanPoints, Planner.Config().inflation_radius))
+        {
+            return;
+        }
+        int changed = DStar.Stats().changed;
+        bool found = DStar.Replan(cy * Planner.Width() + cx, Cells);
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (!found)
+        {
+            ROS_WARN("Replan on %s: no path around %d new cells, %d nodes expanded in %.2f ms", reason, changed,
+                     DStar.Stats().expanded, elapsed);
+            return;
+        }
+
+        // Robot First, Then Cell Centres, Ending on the Goal Position When Its Cell Is the Goal Cell
+        int gx, gy;
+        Waypoints.clear();
+        GridPlanner::Point_t robot = {pose_x, pose_y};
+        Waypoints.push_back(robot);
+        for (size_t i = Cells[0] == cy * Planner.Width() + cx ? 1 : 0; i < Cells.size(); i++)
+        {
+            Waypoints.push_back(Planner.CellCenter(Cells[i]));
+        }
+        if (Planner.WorldToCell(GoalMsg.pose.position.x, GoalMsg.pose.position.y, gx, gy) &&
+            gy * Planner.Width() + gx == DStar.Goal() && Waypoints.size() > 1)
+        {
+            Waypoints.back().x = GoalMsg.pose.position.x;
+            Waypoints.back().y = GoalMsg.pose.position.y;
+        }
+        PublishPath();
+
+        ROS_INFO("Replan on %s: path of %zu poses around %d new cells, %d nodes expanded in %.2f ms", reason,
+                 Waypoints.size(), changed, DStar.Stats().expanded, elapsed);
+    }
+
+    void PublishPath()
+    {
+        // Heading Along the Path, the Goal Heading on the Last Pose When the Goal Has One
+        const geometry_msgs::Quaternion &q = GoalMsg.pose.orientation;
+        bool goal_heading = q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w > 0.5;
+        double yaw = 0.0;
+        PathMsg.header.stamp = ros::Time::now();
+        PathMsg.header.frame_id = FrameId;
+        PathMsg.poses.resize(Waypoints.size());
+        for (size_t i = 0; i < Waypoints.size(); i++)
+        {
+            geometry_msgs::PoseStamped &pose = PathMsg.poses[i];
+            pose.header = PathMsg.header;
+            pose.pose.position.x = Waypoints[i].x;
+            pose.pose.position.y = Waypoints[i].y;
+            pose.pose.position.z = 0.0;
+            if (i + 1 < Waypoints.size())
+            {
+                yaw = atan2(Waypoints[i + 1].y - Waypoints[i].y, Waypoints[i + 1].x - Waypoints[i].x);
+            }
+            pose.pose.orientation = (i + 1 == Waypoints.size() && goal_heading) ? q : tf::createQuaternionMsgFromYaw(yaw);
+        }
+        PathPub.publish(PathMsg);
+    }
+};
+
+int main(int argc, char** argv)
+{
+    ros::init(argc, argv, "planner");
+
+    PlannerNode planner;
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <ros/ros.h>
+#include <tf/transform_broadcaster.h>
+#include <nav_msgs/Odometry.h>
+#include <geometry_msgs/PoseWithCovarianceStamped.h>
+
+#include "main_controller/ControllerData.h"
+#include "omni_sim.h"
+
+// Stands in for the STM32 base, the odometry and AMCL: takes robot/cmd_vel from robot_node,
+// moves the simulated base and publishes /odom and /amcl_pose from it in real time.
+// For faster than real time runs without ROS use control_sim.
+class BaseSimNode
+{
+public:
+    BaseSimNode()
+    {
+        ros::NodeHandle Nh_Private("~");
+
+        double  rate, odom_rate, amcl_rate;
+        OmniBaseSim::Pose_t start;
+        OmniBaseSim::Config_t config;
+        Nh_Private.param("rate", rate, 200.0);
+        Nh_Private.param("odom_rate", odom_rate, 50.0);
+        Nh_Private.param("amcl_rate", amcl_rate, 10.0);
+        Nh_Private.param("initial_x", start.x, 0.0f);
+        Nh_Private.param("initial_y", start.y, 0.0f);
+        Nh_Private.param("initial_theta", start.theta, 0.0f);
+        Nh_Private.param("tau_linear", config.tau_linear, 0.15f);
+        Nh_Private.param("tau_angular", config.tau_angular, 0.1f);
+        Nh_Private.param("max_accel", config.max_accel, 80.0f);
+        Nh_Private.param("max_angular_accel", config.max_angular_accel, 120.0f);
+        Nh_Private.param("angular_scale", config.angular_scale, 57.29578f);
+        Nh_Private.param("odom_scale_error", config.odom_scale_error, 0.02f);
+
+        Base.Configure(config);
+        Base.Reset(start);
+
+        SpeedSub = Nh.subscribe("robot/cmd_vel", 10, &BaseSimNode::SpeedSubCallback, this);
+        OdomPub  = Nh.advertise<nav_msgs::Odometry>("odom", 50);
+        AmclPub  = Nh.advertise<geometry_msgs::PoseWithCovarianceStamped>("/amcl_pose", 10);
+
+        PrevTime   = ros::Time::now();
+        StepTimer  = Nh.createTimer(ros::Duration(1.0 / rate), &BaseSimNode::StepEvent, this);
+        OdomTimer  = Nh.createTimer(ros::Duration(1.0 / odom_rate), &BaseSimNode::OdomEvent, this);
+        AmclTimer  = Nh.createTimer(ros::Duration(1.0 / amcl_rate), &BaseSimNode::AmclEvent, this);
+
+        ROS_INFO("Simulated base at (%.2f, %.2f, %.2f)", start.x, start.y, start.theta);
+        ros::spin();
+    }
+
+private:
+    ros::NodeHandle     Nh;
+    ros::Subscriber     SpeedSub;
+    ros::Publisher      OdomPub;
+    ros::Publisher      AmclPub;
+    ros::Timer          StepTimer;
+    ros::Timer          OdomTimer;
+    ros::Timer          AmclTimer;
+    ros::Time           PrevTime;
+
+    tf::TransformBroadcaster    Broadcaster;
+    OmniBaseSim                 Base;
+    float                       Command[3] = {0, 0, 0};
+
+    void SpeedSubCallback(const main_controller::ControllerData &msg)
+    {
+        if(msg.data.size() < 3)
+        {
+            return;
+        }
+        // Fine Command When the Sender Provides It
+        bool fine = msg.velocity.size() >= 3;
+        for(int i = 0; i < 3; i++)
+        {
+            Command[i] = fine ? msg.velocity[i] : msg.data[i];
+        }
+    }
+
+    void StepEvent(const ros::TimerEvent &event)
+    {
+        ros::Time now = ros::Time::now();
+        Base.Step(Command, (now - PrevTime).toSec());
+        PrevTime = now;
+    }
+
+    void OdomEvent(const ros::TimerEvent &event)
+    {
+        OmniBaseSim::Pose_t pose = Base.Odom();
+        OmniBaseSim::Pose_t vel = Base.Velocity();
+        ros::Time now = ros::Time::now();
+
+        nav_msgs::Odometry odom;
+        odom.header.stamp = now;
+        odom.header.frame_id = "odom";
+        odom.child_frame_id = "base_link";
+        odom.pose.pose.position.x = pose.x;
+        odom.pose.pose.position.y = pose.y;
+        odom.pose.pose.orientation = tf::createQuaternionMsgFromYaw(pose.theta);
+        odom.twist.twist.linear.x = vel.x;
+        odom.twist.twist.linear.y = vel.y;
+        odom.twist.twist.angular.z = vel.theta;
+        OdomPub.publish(odom);
+
+        tf::Transform transform;
+        transform.setOrigin(tf::Vector3(pose.x, pose.y, 0.0));
+        transform.setRotation(tf::createQuaternionFromYaw(pose.theta));
+        Broadcaster.sendTransform(tf::StampedTransform(transform, now, "odom", "base_link"));
+    }
+
+    void AmclEvent(const ros::TimerEvent &event)
+    {
+        OmniBaseSim::Pose_t pose = Base.Pose();
+
+        geometry_msgs::PoseWithCovarianceStamped amcl;
+        amcl.header.stamp = ros::Time::now();
+        amcl.header.frame_id = "map";
+        amcl.pose.pose.position.x = pose.x;
+        amcl.pose.pose.position.y = pose.y;
+        amcl.pose.pose.orientation = tf::createQuaternionMsgFromYaw(pose.theta);
+        amcl.pose.covariance[0]  = 0.0025;
+        amcl.pose.covariance[7]  = 0.0025;
+        amcl.pose.covariance[35] = 0.003;
+        AmclPub.publish(amcl);
+    }
+};
+
+int main(int argc, char** argv)
+{
+    ros::init(argc, argv, "base_sim");
+
+    BaseSimNode sim;
+
+    return 0;
+}
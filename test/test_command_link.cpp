@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <vector>
+
+#include "command_link.h"
+
+// Ack for the command frame just encoded, completed with its CRC
+static int MakeAck(const uint8_t* command, uint8_t ack[CommandLink::MAX_FRAME])
+{
+    const uint8_t header[] = {0xA5, 0x5A, 1, 0x81, 4, command[5], command[6], 0, 0};
+    memcpy(ack, header, sizeof(header));
+    uint16_t crc = CommandLink::Crc16(ack + 2, sizeof(header) - 2);
+    ack[sizeof(header)] = crc & 0xFF;
+    ack[sizeof(header) + 1] = crc >> 8;
+    return sizeof(header) + 2;
+}
+
+TEST(CommandLink, AckSplitAcrossCallsLeavesText)
+{
+    CommandLink link;
+    link.SetProtocol(CommandLink::V1);
+    CommandLink::Command_t command = {};
+    uint8_t frame[CommandLink::MAX_FRAME];
+    link.Encode(command, 0.0, frame);
+
+    uint8_t ack[CommandLink::MAX_FRAME];
+    int ack_length = MakeAck(frame, ack);
+
+    uint8_t buf[64];
+    memcpy(buf, "12,34", 5);
+    memcpy(buf + 5, ack, 3);
+    ASSERT_EQ(link.Extract(buf, 8, sizeof(buf), 0.01), 5);
+    EXPECT_EQ(memcmp(buf, "12,34", 5), 0);
+
+    memcpy(buf, ack + 3, ack_length - 3);
+    memcpy(buf + ack_length - 3, ",56", 3);
+    ASSERT_EQ(link.Extract(buf, ack_length, sizeof(buf), 0.02), 3);
+    EXPECT_EQ(memcmp(buf, ",56", 3), 0);
+    EXPECT_EQ(link.GetStats(false).acked, 1u);
+}
+
+TEST(CommandLink, BrokenCarriedHeaderStaysWithinCapacity)
+{
+    CommandLink link;
+    link.SetProtocol(CommandLink::V1);
+
+    // Sync, Version and Type at the End of One Read Are Held Back for the Next
+    uint8_t first[] = {'1', '2', 0xA5, 0x5A, 1, 0x81};
+    ASSERT_EQ(link.Extract(first, sizeof(first), sizeof(first), 0.0), 2);
+
+    // A Full Read Whose First Byte Makes the Payload Too Long, the Header Comes Back as Text
+    const int capacity = CommandLink::MAX_RECEIVE;
+    const int guard = 2 * CommandLink::MAX_FRAME;
+    std::vector<uint8_t> buf(capacity + guard, 0xEE);
+    buf[0] = 0xFF;
+    memset(buf.data() + 1, 'x', capacity - 1);
+
+    int n = link.Extract(buf.data(), capacity, capacity, 0.01);
+    EXPECT_LE(n, capacity);
+    EXPECT_EQ(buf[0], 0x5A);
+    EXPECT_EQ(buf[n - 1], 'x');
+    for(int i = capacity; i < capacity + guard; i++)
+    {
+        ASSERT_EQ(buf[i], 0xEE) << "written past capacity at " << i;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "control_core.h"
+#include "omni_sim.h"
+#include "scan_collision.h"
+
+// Peak translation command (cm/s) while tracking a 4 m straight for 10 s, with a scan
+// without returns when open is set
+static float PeakSpeed(const std::string &controller, bool open)
+{
+    ControlCore core;
+    core.RequestController(controller);
+
+    TrackingPath_t path;
+    std::vector<float> x, y, theta;
+    for(int i = 0; i <= 80; i++)
+    {
+        x.push_back(0.05 * i);
+        y.push_back(0.0);
+        theta.push_back(0.0);
+        path.x.push(x.back());
+        path.y.push(0.0);
+        path.theta.push(0.0);
+    }
+    path.curve.Fit(x, y, theta);
+
+    ScanCollisionChecker scan;
+    std::vector<float> ranges(720, 100.0);
+    scan.Update(-M_PI, 2 * M_PI / ranges.size(), ranges.data(), ranges.size(), 0.1, 30.0);
+
+    ControlCore::Input_t input = ControlCore::Input_t();
+    input.scan = open ? &scan : NULL;
+
+    OmniBaseSim base;
+    const float dt = 0.005;
+    float peak = 0.0;
+    for(int tick = 0; tick < 2000; tick++)
+    {
+        // Guided and Running from the First Tick
+        input.buttons[ControlCore::OPTIONS] = (tick == 0);
+        input.buttons[ControlCore::TRIANGLE] = (tick == 0);
+        input.path = (tick == 0) ? &path : NULL;
+
+        OmniBaseSim::Pose_t pose = base.Pose();
+        input.pose.x = pose.x;
+        input.pose.y = pose.y;
+        input.pose.theta = pose.theta;
+
+        const ControlCore::Output_t &out = core.Step(input, tick == 0 ? 0.0 : dt);
+        peak = std::max(peak, (float)hypot(out.velocity[0], out.velocity[1]));
+        if(out.path_finished)
+        {
+            break;
+        }
+
+        float command[3];
+        for(int i = 0; i < 3; i++)
+        {
+            command[i] = out.command[i];
+        }
+        base.Step(command, dt);
+    }
+    return peak;
+}
+
+TEST(ControlCore, GovernorRaisesSpeedOnOpenStraight)
+{
+    const float governor_max = ControlCore::DefaultConfig().governor.max_speed;
+    for(const char* controller : {"lqr", "mpc"})
+    {
+        float peak = PeakSpeed(controller, true);
+        EXPECT_GT(peak, 40.0) << controller;
+        EXPECT_LE(peak, governor_max + 0.5) << controller;
+    }
+}
+
+TEST(ControlCore, FixedLimitWithoutScan)
+{
+    const float max_speed = ControlCore::DefaultConfig().max_speed;
+    for(const char* controller : {"lqr", "mpc"})
+    {
+        EXPECT_LE(PeakSpeed(controller, false), max_speed + 0.5) << controller;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "rolling_bit_grid.h"
+
+static const float RANGE_MIN = 0.05;
+static const float RANGE_MAX = 10.0;
+
+// One Scan of count Beams over a Full Turn, All at the Same Range
+static void InsertRing(RollingBitGrid &grid, float range, float range_max = RANGE_MAX)
+{
+    const int count = 720;
+    RollingBitGrid::Pose_t pose = {0.0, 0.0, 0.0};
+    std::vector<float> ranges(count, range);
+    grid.InsertScan(pose, -M_PI, 2 * M_PI / count, ranges.data(), count, RANGE_MIN, range_max);
+}
+
+TEST(RollingBitGrid, ReturnMarksCell)
+{
+    RollingBitGrid grid;
+    grid.Configure(4.0, 0.05, 0.3);
+    grid.Scroll(0.0, 0.0);
+    InsertRing(grid, 1.02);
+    EXPECT_TRUE(grid.Occupied(1.02, 0.02));
+    EXPECT_FALSE(grid.Occupied(0.5, 0.02));
+}
+
+TEST(RollingBitGrid, NoReturnClearsStaleCell)
+{
+    RollingBitGrid grid;
+    grid.Configure(4.0, 0.05, 0.3);
+    grid.Scroll(0.0, 0.0);
+    InsertRing(grid, 1.02);
+    ASSERT_TRUE(grid.Occupied(1.02, 0.02));
+
+    // The Obstacle Moved Away into Open Space
+    InsertRing(grid, std::numeric_limits<float>::infinity());
+    EXPECT_FALSE(grid.Occupied(1.02, 0.02));
+    EXPECT_FALSE(grid.Occupied(1.9, 0.02));
+}
+
+TEST(RollingBitGrid, ReturnAtRangeMaxMarksNothing)
+{
+    RollingBitGrid grid;
+    grid.Configure(4.0, 0.05, 0.3);
+    grid.Scroll(0.0, 0.0);
+
+    // A Sensor Reporting Its Maximum Range Has Seen Nothing There
+    InsertRing(grid, 1.02, 1.02);
+    EXPECT_FALSE(grid.Occupied(1.02, 0.02));
+    InsertRing(grid, 1.02, 1.03);
+    EXPECT_TRUE(grid.Occupied(1.02, 0.02));
+}
+
+TEST(RollingBitGrid, InvalidReturnLeavesGrid)
+{
+    RollingBitGrid grid;
+    grid.Configure(4.0, 0.05, 0.3);
+    grid.Scroll(0.0, 0.0);
+    InsertRing(grid, 1.02);
+    InsertRing(grid, std::numeric_limits<float>::quiet_NaN());
+    EXPECT_TRUE(grid.Occupied(1.02, 0.02));
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,445 @@
+// Headless closed-loop simulation of the path tracking pipeline, no ROS required.
+//
+//   control_sim [options] [route.csv ...]
+//
+// Each route is a CSV of "x, y, theta" waypoints (header line optional). Without routes a
+// built-in set is used. The simulated base starts on the first waypoint; AMCL and odometry
+// are sampled from it at their own rates and fused by the same PosePredictor as robot_node,
+// ControlCore steps at the control rate and its command drives OmniBaseSim. With --open_scan
+// every tick also gets a laser scan without returns, so the speed governor sees free space.
+// Simulated time advances as fast as the CPU allows.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "control_core.h"
+#include "omni_sim.h"
+#include "pose_predictor.h"
+#include "scan_collision.h"
+
+struct Route_t{
+    std::string        name;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> theta;
+};
+
+struct Options_t{
+    std::vector<std::string> controllers;
+    std::vector<std::string> routes;
+    float   rate;
+    float   amcl_rate;
+    float   odom_rate;
+    float   timeout;
+    float   reference_speed;
+    bool    spline;
+    bool    open_scan;
+    const char* json;
+    OmniBaseSim::Config_t base;
+};
+
+struct Result_t{
+    std::string route;
+    std::string controller;
+    bool    reached;
+    double  time_to_goal;
+    double  cte_mean;
+    double  cte_rms;
+    double  cte_max;
+    double  final_error;
+    double  max_speed;          // Peak achieved translation (cm/s)
+    double  cpu_mean_ns;
+    double  cpu_max_ns;
+    long    ticks;
+    double  realtime_factor;
+};
+
+static bool LoadRoute(const std::string &filename, Route_t &route)
+{
+    std::ifstream file(filename.c_str());
+    if(!file)
+    {
+        return false;
+    }
+
+    route.name = filename;
+    std::string line;
+    while(std::getline(file, line))
+    {
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream fields(line);
+        float x, y, theta;
+        if(fields >> x >> y >> theta)
+        {
+            route.x.push_back(x);
+            route.y.push_back(y);
+            route.theta.push_back(theta);
+        }
+    }
+    return !route.x.empty();
+}
+
+static void AddPoint(Route_t &route, float x, float y, float theta)
+{
+    route.x.push_back(x);
+    route.y.push_back(y);
+    route.theta.push_back(theta);
+}
+
+// Planner-like Routes: 5 cm Grid Steps Along Straights, Curves and Corners
+static std::vector<Route_t> BuiltinRoutes()
+{
+    std::vector<Route_t> routes;
+
+    Route_t straight;
+    straight.name = "straight_4m";
+    for(int i = 0; i <= 80; i++)
+    {
+        AddPoint(straight, 0.05 * i, 0.0, 0.0);
+    }
+    routes.push_back(straight);
+
+    Route_t s_curve;
+    s_curve.name = "s_curve_6m";
+    for(int i = 0; i <= 120; i++)
+    {
+        float s = 0.05 * i;
+        AddPoint(s_curve, s, 0.6 * sin(s * 2.0 * M_PI / 6.0), atan2(0.6 * 2.0 * M_PI / 6.0 * cos(s * 2.0 * M_PI / 6.0), 1.0));
+    }
+    routes.push_back(s_curve);
+
+    Route_t corner;
+    corner.name = "corner_3m";
+    for(int i = 0; i <= 30; i++)
+    {
+        AddPoint(corner, 0.05 * i, 0.0, 0.0);
+    }
+    for(int i = 1; i <= 30; i++)
+    {
+        AddPoint(corner, 1.5, 0.05 * i, M_PI / 2);
+    }
+    routes.push_back(corner);
+
+    return routes;
+}
+
+// Distance to the Waypoint Polyline, Searched Forward from the Last Closest Segment
+static float CrossTrackError(const Route_t &route, float x, float y, size_t &segment)
+{
+    if(route.x.size() == 1)
+    {
+        return hypot(x - route.x[0], y - route.y[0]);
+    }
+
+    float best = 1e9;
+    size_t best_segment = segment;
+    size_t last = std::min(route.x.size() - 1, segment + 40);
+    for(size_t i = segment; i < last; i++)
+    {
+        float dx = route.x[i+1] - route.x[i];
+        float dy = route.y[i+1] - route.y[i];
+        float length2 = dx * dx + dy * dy;
+        float u = (length2 > 0.0) ? ((x - route.x[i]) * dx + (y - route.y[i]) * dy) / length2 : 0.0;
+        u = std::min(std::max(u, 0.0f), 1.0f);
+        float distance = hypot(x - (route.x[i] + u * dx), y - (route.y[i] + u * dy));
+        if(distance < best)
+        {
+            best = distance;
+            best_segment = i;
+        }
+    }
+    segment = best_segment;
+    return best;
+}
+
+static Result_t RunRoute(const Route_t &route, const std::string &controller_name, const Options_t &options)
+{
+    Result_t result;
+    result.route = route.name;
+    result.controller = controller_name;
+    result.reached = false;
+    result.time_to_goal = 0.0;
+
+    ControlCore::Config_t config = ControlCore::DefaultConfig();
+    config.use_path_spline = options.spline;
+    config.mpc_reference_speed = options.reference_speed;
+
+    ControlCore core;
+    core.Configure(config);
+    core.RequestController(controller_name);
+
+    TrackingPath_t path;
+    for(size_t i = 0; i < route.x.size(); i++)
+    {
+        path.x.push(route.x[i]);
+        path.y.push(route.y[i]);
+        path.theta.push(route.theta[i]);
+    }
+    if(options.spline)
+    {
+        path.curve.Fit(route.x, route.y, route.theta);
+    }
+
+    OmniBaseSim base;
+    base.Configure(options.base);
+    OmniBaseSim::Pose_t start = {route.x[0], route.y[0], route.theta[0]};
+    base.Reset(start);
+
+    PosePredictor predictor;
+    ControlCore::Input_t input = ControlCore::Input_t();
+
+    // Scan Without Returns, Every Beam Beyond range_max
+    ScanCollisionChecker scan;
+    if(options.open_scan)
+    {
+        std::vector<float> ranges(720, 100.0);
+        scan.Update(-M_PI, 2.0 * M_PI / ranges.size(), ranges.data(), ranges.size(), 0.1, 30.0);
+        input.scan = &scan;
+    }
+    float command[3] = {0.0, 0.0, 0.0};
+
+    const double dt = 1.0 / options.rate;
+    const double odom_period = 1.0 / options.odom_rate;
+    const double amcl_period = 1.0 / options.amcl_rate;
+    double next_odom = 0.0;
+    double next_amcl = 0.0;
+    double cte_sum = 0.0, cte_sum2 = 0.0, cte_max = 0.0;
+    double cpu_sum = 0.0, cpu_max = 0.0;
+    double max_speed = 0.0;
+    size_t segment = 0;
+    long ticks = 0;
+
+    std::chrono::steady_clock::time_point wall_start = std::chrono::steady_clock::now();
+
+    double t = 0.0;
+    for(; t < options.timeout; t += dt)
+    {
+        // Sensors at Their Own Rates
+        if(t >= next_odom)
+        {
+            OmniBaseSim::Pose_t odom = base.Odom();
+            PosePredictor::Pose_t odom_pose = {odom.x, odom.y, odom.theta};
+            predictor.AddOdom(t, odom_pose);
+            next_odom += odom_period;
+        }
+        if(t >= next_amcl)
+        {
+            OmniBaseSim::Pose_t truth = base.Pose();
+            PosePredictor::Pose_t map_pose = {truth.x, truth.y, truth.theta};
+            predictor.SetMapPose(t, map_pose);
+            next_amcl += amcl_period;
+        }
+
+        // Press OPTIONS and TRIANGLE on the First Tick, Release on the Second: Guided and Running
+        input.buttons[ControlCore::OPTIONS] = (ticks == 0);
+        input.buttons[ControlCore::TRIANGLE] = (ticks == 0);
+        input.path = (ticks == 0) ? &path : NULL;
+
+        // Control Step, Same Core as Robot::ControlTick
+        std::chrono::steady_clock::time_point tick_start = std::chrono::steady_clock::now();
+
+        PosePredictor::Pose_t predicted;
+        if(predictor.Predict(predicted))
+        {
+            input.pose.x = predicted.x;
+            input.pose.y = predicted.y;
+            input.pose.theta = predicted.theta;
+        }
+
+        const ControlCore::Output_t &out = core.Step(input, ticks == 0 ? 0.0 : dt);
+        for(int i = 0; i < 3; i++)
+        {
+            command[i] = out.command[i];
+        }
+        bool finished = out.path_finished;
+
+        double cpu = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - tick_start).count();
+        cpu_sum += cpu;
+        cpu_max = std::max(cpu_max, cpu);
+        ticks++;
+
+        OmniBaseSim::Pose_t truth = base.Pose();
+        double cte = CrossTrackError(route, truth.x, truth.y, segment);
+        cte_sum += cte;
+        cte_sum2 += cte * cte;
+        cte_max = std::max(cte_max, cte);
+
+        OmniBaseSim::Pose_t velocity = base.Velocity();
+        max_speed = std::max(max_speed, 100.0 * hypot(velocity.x, velocity.y));
+
+        if(finished)
+        {
+            result.reached = true;
+            result.time_to_goal = t;
+            break;
+        }
+
+        base.Step(command, dt);
+    }
+
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    OmniBaseSim::Pose_t truth = base.Pose();
+    result.final_error = hypot(truth.x - route.x.back(), truth.y - route.y.back());
+    result.cte_mean = cte_sum / ticks;
+    result.cte_rms = sqrt(cte_sum2 / ticks);
+    result.cte_max = cte_max;
+    result.max_speed = max_speed;
+    result.cpu_mean_ns = cpu_sum / ticks;
+    result.cpu_max_ns = cpu_max;
+    result.ticks = ticks;
+    result.realtime_factor = (wall > 0.0) ? t / wall : 0.0;
+    return result;
+}
+
+static bool WriteJson(const char* filename, const std::vector<Result_t> &results)
+{
+    FILE* file = fopen(filename, "w");
+    if(!file)
+    {
+        return false;
+    }
+
+    fprintf(file, "{\n  \"runs\": [\n");
+    for(size_t i = 0; i < results.size(); i++)
+    {
+        const Result_t &r = results[i];
+        fprintf(file, "    {\"route\": \"%s\", \"controller\": \"%s\", \"reached\": %s, \"time_to_goal\": %.3f, "
+                      "\"cte_mean\": %.4f, \"cte_rms\": %.4f, \"cte_max\": %.4f, \"final_error\": %.4f, "
+                      "\"max_speed\": %.1f, \"cpu_mean_ns\": %.1f, \"cpu_max_ns\": %.1f, \"ticks\": %ld, \"realtime_factor\": %.1f}%s\n",
+                r.route.c_str(), r.controller.c_str(), r.reached ? "true" : "false", r.time_to_goal,
+                r.cte_mean, r.cte_rms, r.cte_max, r.final_error, r.max_speed, r.cpu_mean_ns, r.cpu_max_ns, r.ticks,
+                r.realtime_factor, (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+    return true;
+}
+
+static void Usage(const char* name)
+{
+    fprintf(stderr,
+        "Usage: %s [options] [route.csv ...]\n"
+        "  --controller <lqr|pid|pid_v2|mpc|all>  (default lqr)\n"
+        "  --rate <hz>             control rate (200)\n"
+        "  --amcl_rate <hz>        map pose rate (10)\n"
+        "  --odom_rate <hz>        odometry rate (50)\n"
+        "  --timeout <s>           simulated time limit per route (120)\n"
+        "  --spline <0|1>          track the fitted curve (1)\n"
+        "  --tau <s>               actuator time constant (0.15)\n"
+        "  --odom_error <ratio>    odometry scale error (0.02)\n"
+        "  --open_scan <0|1>       feed a scan without returns, the governor sees free space (0)\n"
+        "  --json <file>           write results as JSON\n", name);
+}
+
+int main(int argc, char** argv)
+{
+    Options_t options;
+    options.rate = 200.0;
+    options.amcl_rate = 10.0;
+    options.odom_rate = 50.0;
+    options.timeout = 120.0;
+    options.reference_speed = 0.25;
+    options.spline = true;
+    options.open_scan = false;
+    options.json = NULL;
+
+    options.base.tau_linear        = 0.15;
+    options.base.tau_angular       = 0.1;
+    options.base.max_accel         = 80.0;
+    options.base.max_angular_accel = 120.0;
+    options.base.angular_scale     = DefaultPathControllerConfig().mpc.angular_scale;
+    options.base.odom_scale_error  = 0.02;
+
+    std::string controller = "lqr";
+    for(int i = 1; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(argv[i], "--controller") && has_value)       controller = argv[++i];
+        else if(!strcmp(argv[i], "--rate") && has_value)        options.rate = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--amcl_rate") && has_value)   options.amcl_rate = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--odom_rate") && has_value)   options.odom_rate = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--timeout") && has_value)     options.timeout = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--spline") && has_value)      options.spline = atoi(argv[++i]) != 0;
+        else if(!strcmp(argv[i], "--tau") && has_value)         options.base.tau_linear = options.base.tau_angular = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--odom_error") && has_value)  options.base.odom_scale_error = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--open_scan") && has_value)   options.open_scan = atoi(argv[++i]) != 0;
+        else if(!strcmp(argv[i], "--json") && has_value)        options.json = argv[++i];
+        else if(argv[i][0] != '-')                              options.routes.push_back(argv[i]);
+        else
+        {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if(controller == "all")
+    {
+        options.controllers = {"lqr", "pid", "pid_v2", "mpc"};
+    }
+    else
+    {
+        PathController_t probe;
+        if(!MakePathController(controller, DefaultPathControllerConfig(), probe))
+        {
+            fprintf(stderr, "Unknown controller '%s'\n", controller.c_str());
+            return 1;
+        }
+        options.controllers.push_back(controller);
+    }
+
+    std::vector<Route_t> routes;
+    if(options.routes.empty())
+    {
+        routes = BuiltinRoutes();
+    }
+    for(const std::string &filename : options.routes)
+    {
+        Route_t route;
+        if(!LoadRoute(filename, route))
+        {
+            fprintf(stderr, "Failed to load route %s\n", filename.c_str());
+            return 1;
+        }
+        routes.push_back(route);
+    }
+
+    std::vector<Result_t> results;
+    printf("%-20s %-8s %-7s %9s %9s %9s %9s %9s %9s %10s %10s %9s\n", "Route", "Ctrl", "Reached", "Goal(s)",
+           "CTEmean", "CTErms", "CTEmax", "FinalErr", "Vmax", "CPUmean", "CPUmax", "xRealtime");
+    for(const Route_t &route : routes)
+    {
+        for(const std::string &name : options.controllers)
+        {
+            Result_t r = RunRoute(route, name, options);
+            printf("%-20s %-8s %-7s %9.2f %9.4f %9.4f %9.4f %9.4f %9.1f %8.0fns %8.0fns %9.0f\n", r.route.c_str(),
+                   r.controller.c_str(), r.reached ? "yes" : "no", r.time_to_goal, r.cte_mean, r.cte_rms,
+                   r.cte_max, r.final_error, r.max_speed, r.cpu_mean_ns, r.cpu_max_ns, r.realtime_factor);
+            results.push_back(r);
+        }
+    }
+
+    if(options.json && !WriteJson(options.json, results))
+    {
+        fprintf(stderr, "Failed to write %s\n", options.json);
+        return 1;
+    }
+
+    // Non-Zero Exit When a Route Was Not Completed, for Regression Scripts
+    for(const Result_t &r : results)
+    {
+        if(!r.reached)
+        {
+            return 2;
+        }
+    }
+    return 0;
+}
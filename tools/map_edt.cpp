@@ -0,0 +1,161 @@
+// Builds the Euclidean distance transform of stored maps and caches it next to them, no ROS required.
+//
+//   map_edt [options] map.yaml ...
+//
+// Each map_server YAML is loaded with its PGM, the distance from every cell to the nearest
+// obstacle is computed and written to the .edt file beside the YAML (maps/katk.yaml ->
+// maps/katk.edt). An up to date cache is reused unless --force is given.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "distance_field.h"
+#include "occupancy_map.h"
+
+struct Options_t{
+    std::vector<std::string> maps;
+    int     threads;
+    bool    force;
+    bool    unknown_is_obstacle;
+    bool    image;
+    float   image_range;
+};
+
+static void Usage(const char* name)
+{
+    fprintf(stderr,
+            "Usage: %s [options] map.yaml ...\n"
+            "  --threads N        Worker threads, 0 for every core (default 0)\n"
+            "  --force            Recompute even when the cache is up to date\n"
+            "  --unknown free|obstacle  Treatment of unknown cells (default obstacle)\n"
+            "  --image            Also write <map>_edt.pgm, white at --range meters or more\n"
+            "  --range M          Distance shown as white in the image (default 2.0)\n",
+            name);
+}
+
+// Grey Levels from 0 at Obstacles to 255 at range, Top Row First like map_server Images
+static bool WriteImage(const std::string &path, const DistanceField &field, float range)
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if(!file)
+    {
+        return false;
+    }
+    fprintf(file, "P5\n# distance transform, %.3f m white\n%d %d\n255\n", range, field.Width(), field.Height());
+    std::vector<unsigned char> row(field.Width());
+    bool ok = true;
+    for(int y = field.Height() - 1; y >= 0 && ok; y--)
+    {
+        for(int x = 0; x < field.Width(); x++)
+        {
+            row[x] = (unsigned char)(255.0f * std::min(field.Distance(x, y) / range, 1.0f));
+        }
+        ok = fwrite(row.data(), 1, row.size(), file) == row.size();
+    }
+    return (fclose(file) == 0) && ok;
+}
+
+int main(int argc, char** argv)
+{
+    Options_t options;
+    options.threads = 0;
+    options.force = false;
+    options.unknown_is_obstacle = true;
+    options.image = false;
+    options.image_range = 2.0;
+
+    for(int i = 1; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        if(!strcmp(argv[i], "--threads") && has_value)          options.threads = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--force"))                    options.force = true;
+        else if(!strcmp(argv[i], "--unknown") && has_value)     options.unknown_is_obstacle = strcmp(argv[++i], "free") != 0;
+        else if(!strcmp(argv[i], "--image"))                    options.image = true;
+        else if(!strcmp(argv[i], "--range") && has_value)       options.image_range = atof(argv[++i]);
+        else if(argv[i][0] != '-')                              options.maps.push_back(argv[i]);
+        else
+        {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if(options.maps.empty() || options.image_range <= 0.0)
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    int failures = 0;
+    printf("%-32s %9s %6s %10s %9s %9s\n", "Map", "Size", "Cache", "Time(ms)", "MaxDist", "MeanFree");
+    for(const std::string &yaml_path : options.maps)
+    {
+        OccupancyMap map;
+        std::string error;
+        if(!map.Load(yaml_path, error))
+        {
+            fprintf(stderr, "%s: %s\n", yaml_path.c_str(), error.c_str());
+            failures++;
+            continue;
+        }
+
+        DistanceField field;
+        std::string cache_path = DistanceField::CachePath(yaml_path);
+        bool from_cache = false;
+        auto start = std::chrono::steady_clock::now();
+        bool saved;
+        if(options.force)
+        {
+            field.Compute(map, options.unknown_is_obstacle, options.threads);
+            saved = field.Save(cache_path, DistanceField::SourceHash(map, options.unknown_is_obstacle));
+        }
+        else
+        {
+            saved = field.LoadOrCompute(map, cache_path, options.unknown_is_obstacle, options.threads, from_cache);
+        }
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if(!saved)
+        {
+            fprintf(stderr, "%s: cannot write %s\n", yaml_path.c_str(), cache_path.c_str());
+            failures++;
+        }
+
+        // Clearance Statistics over Free Cells
+        float max_distance = 0.0;
+        double free_sum = 0.0;
+        long free_cells = 0;
+        for(int y = 0; y < map.Height(); y++)
+        {
+            for(int x = 0; x < map.Width(); x++)
+            {
+                if(map.At(x, y) == OccupancyMap::FREE)
+                {
+                    float d = field.Distance(x, y);
+                    max_distance = std::max(max_distance, d);
+                    free_sum += d;
+                    free_cells++;
+                }
+            }
+        }
+
+        char size[32];
+        snprintf(size, sizeof(size), "%dx%d", map.Width(), map.Height());
+        printf("%-32s %9s %6s %10.2f %9.2f %9.2f\n", yaml_path.c_str(), size, from_cache ? "hit" : "built",
+               elapsed, max_distance, free_cells ? free_sum / free_cells : 0.0);
+
+        if(options.image)
+        {
+            std::string image_path = cache_path.substr(0, cache_path.size() - 4) + "_edt.pgm";
+            if(!WriteImage(image_path, field, options.image_range))
+            {
+                fprintf(stderr, "%s: cannot write %s\n", yaml_path.c_str(), image_path.c_str());
+                failures++;
+            }
+        }
+    }
+    return failures ? 1 : 0;
+}